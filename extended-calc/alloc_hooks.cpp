@@ -0,0 +1,104 @@
+/**
+ * @file		alloc_hooks.cpp
+ * Contains replacements for the global allocation functions that feed the
+ * allocation statistics. Link this file into an executable, not into the
+ * library, so that programs can still replace the functions themselves.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "instrument.hpp"
+
+namespace {
+	/// Each block begins with a header that holds its size. The header is as
+	/// large as the strictest fundamental alignment, so the memory returned
+	/// to the caller remains suitably aligned.
+	const std::size_t header_size = alignof(std::max_align_t);
+
+	void* allocate(std::size_t size) noexcept {
+		unsigned char* block = static_cast<unsigned char*>(
+			std::malloc(size + header_size));
+		if (!block)
+			return nullptr;
+		*reinterpret_cast<std::size_t*>(block) = size;
+		calc::record_allocation(size);
+		return block + header_size;
+	}
+
+	void* allocate_or_throw(std::size_t size) {
+		while (true) {
+			if (void* p = allocate(size))
+				return p;
+			std::new_handler handler = std::get_new_handler();
+			if (!handler)
+				throw std::bad_alloc();
+			handler();
+		}
+	}
+
+	void deallocate(void* p) noexcept {
+		if (!p)
+			return;
+		unsigned char* block = static_cast<unsigned char*>(p) - header_size;
+		calc::record_deallocation(*reinterpret_cast<std::size_t*>(block));
+		std::free(block);
+	}
+} // namespace
+
+void* operator new(std::size_t size) {
+	return allocate_or_throw(size);
+}
+
+void* operator new[](std::size_t size) {
+	return allocate_or_throw(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	try {
+		return allocate_or_throw(size);
+	}
+	catch (const std::bad_alloc&) {
+		return nullptr;
+	}
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	try {
+		return allocate_or_throw(size);
+	}
+	catch (const std::bad_alloc&) {
+		return nullptr;
+	}
+}
+
+void operator delete(void* p) noexcept {
+	deallocate(p);
+}
+
+void operator delete[](void* p) noexcept {
+	deallocate(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+	deallocate(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+	deallocate(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	deallocate(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+	deallocate(p);
+}
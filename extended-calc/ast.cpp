@@ -60,24 +60,63 @@ namespace calc {
 		return this->_right_operand.get();
 	}
 
+	/**
+	 * Gets the value of an integer_value or a bigint_value.
+	 * @return	@c false if @p v is not an integer.
+	 */
+	static bool get_bigint(const value& v, bigint& result) {
+		if (const integer_value* integer_v = dynamic_cast<const integer_value*>(&v)) {
+			result = bigint(integer_v->to_integer());
+			return true;
+		}
+		if (const bigint_value* bigint_v = dynamic_cast<const bigint_value*>(&v)) {
+			result = bigint_v->to_bigint();
+			return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Makes the value of an integer result that integer_t could not
+	 * compute, which overflowed unless the build has ENABLE_BIGINT.
+	 */
+	static std::unique_ptr<value> promote(bigint&& v, const char* what) {
+#if ENABLE_BIGINT
+		integer_t small;
+		if (v.narrow<default_integer_policy>(small))
+			return std::make_unique<integer_value>(small);
+		return std::make_unique<bigint_value>(std::move(v));
+#else
+		static_cast<void>(v);
+		throw std::overflow_error(what);
+#endif
+	}
+
 	std::unique_ptr<class value> positive_expr::value() const {
 		std::unique_ptr<class value> v = this->operand()->value();
 		integer_value* integer_v = dynamic_cast<integer_value*>(v.get());
 
-		if (!integer_v)
+		if (integer_v)
+			return std::make_unique<integer_value>(+integer_v->to_integer());
+		if (!dynamic_cast<bigint_value*>(v.get()))
 			throw std::invalid_argument("calc::positive_expr::value");
 
-		return std::make_unique<integer_value>(+integer_v->to_int32());
+		return v;
 	}
 
 	std::unique_ptr<class value> negative_expr::value() const {
 		std::unique_ptr<class value> v = this->operand()->value();
 		integer_value* integer_v = dynamic_cast<integer_value*>(v.get());
 
-		if (!integer_v)
+		integer_t result;
+		if (integer_v && !default_integer_policy::negate(integer_v->to_integer(), result))
+			return std::make_unique<integer_value>(result);
+
+		bigint operand;
+		if (!get_bigint(*v, operand))
 			throw std::invalid_argument("calc::negative_expr::value");
 
-		return std::make_unique<integer_value>(-integer_v->to_int32());
+		return promote(-operand, "calc::negative_expr::value");
 	}
 
 	std::unique_ptr<class value> addition_expr::value() const {
@@ -86,11 +125,16 @@ namespace calc {
 		integer_value* left_integer_v = dynamic_cast<integer_value*>(left_v.get());
 		integer_value* right_integer_v = dynamic_cast<integer_value*>(right_v.get());
 
-		if (!left_integer_v || !right_integer_v)
+		integer_t result;
+		if (left_integer_v && right_integer_v
+		    && !default_integer_policy::add(left_integer_v->to_integer(), right_integer_v->to_integer(), result))
+			return std::make_unique<integer_value>(result);
+
+		bigint left, right;
+		if (!get_bigint(*left_v, left) || !get_bigint(*right_v, right))
 			throw std::invalid_argument("calc::addition_expr::value");
 
-		return std::make_unique<integer_value>(left_integer_v->to_int32()
-		                                       + right_integer_v->to_int32());
+		return promote(left + right, "calc::addition_expr::value");
 	}
 
 	std::unique_ptr<class value> subtraction_expr::value() const {
@@ -99,11 +143,16 @@ namespace calc {
 		integer_value* left_integer_v = dynamic_cast<integer_value*>(left_v.get());
 		integer_value* right_integer_v = dynamic_cast<integer_value*>(right_v.get());
 
-		if (!left_integer_v || !right_integer_v)
+		integer_t result;
+		if (left_integer_v && right_integer_v
+		    && !default_integer_policy::subtract(left_integer_v->to_integer(), right_integer_v->to_integer(), result))
+			return std::make_unique<integer_value>(result);
+
+		bigint left, right;
+		if (!get_bigint(*left_v, left) || !get_bigint(*right_v, right))
 			throw std::invalid_argument("calc::subtraction_expr::value");
 
-		return std::make_unique<integer_value>(left_integer_v->to_int32()
-		                                       - right_integer_v->to_int32());
+		return promote(left - right, "calc::subtraction_expr::value");
 	}
 
 	std::unique_ptr<class value> multiplication_expr::value() const {
@@ -112,11 +161,16 @@ namespace calc {
 		integer_value* left_integer_v = dynamic_cast<integer_value*>(left_v.get());
 		integer_value* right_integer_v = dynamic_cast<integer_value*>(right_v.get());
 
-		if (!left_integer_v || !right_integer_v)
+		integer_t result;
+		if (left_integer_v && right_integer_v
+		    && !default_integer_policy::multiply(left_integer_v->to_integer(), right_integer_v->to_integer(), result))
+			return std::make_unique<integer_value>(result);
+
+		bigint left, right;
+		if (!get_bigint(*left_v, left) || !get_bigint(*right_v, right))
 			throw std::invalid_argument("calc::multiplication_expr::value");
 
-		return std::make_unique<integer_value>(left_integer_v->to_int32()
-		                                       * right_integer_v->to_int32());
+		return promote(left * right, "calc::multiplication_expr::value");
 	}
 
 	std::unique_ptr<class value> division_expr::value() const {
@@ -125,13 +179,18 @@ namespace calc {
 		integer_value* left_integer_v = dynamic_cast<integer_value*>(left_v.get());
 		integer_value* right_integer_v = dynamic_cast<integer_value*>(right_v.get());
 
-		if (!left_integer_v || !right_integer_v)
+		integer_t result;
+		if (left_integer_v && right_integer_v && right_integer_v->to_integer() != 0
+		    && !default_integer_policy::divide(left_integer_v->to_integer(), right_integer_v->to_integer(), result))
+			return std::make_unique<integer_value>(result);
+
+		bigint left, right;
+		if (!get_bigint(*left_v, left) || !get_bigint(*right_v, right))
 			throw std::invalid_argument("calc::division_expr::value");
-		if (right_integer_v->to_int32() == 0)
+		if (right.is_zero())
 			throw std::domain_error("calc::division_expr::value");
 
-		return std::make_unique<integer_value>(left_integer_v->to_int32()
-		                                       / right_integer_v->to_int32());
+		return promote(left / right, "calc::division_expr::value");
 	}
 
 	std::unique_ptr<class value> modulus_expr::value() const {
@@ -140,20 +199,25 @@ namespace calc {
 		integer_value* left_integer_v = dynamic_cast<integer_value*>(left_v.get());
 		integer_value* right_integer_v = dynamic_cast<integer_value*>(right_v.get());
 
-		if (!left_integer_v || !right_integer_v)
+		integer_t result;
+		if (left_integer_v && right_integer_v && right_integer_v->to_integer() != 0
+		    && !default_integer_policy::modulo(left_integer_v->to_integer(), right_integer_v->to_integer(), result))
+			return std::make_unique<integer_value>(result);
+
+		bigint left, right;
+		if (!get_bigint(*left_v, left) || !get_bigint(*right_v, right))
 			throw std::invalid_argument("calc::modulus_expr::value");
-		if (right_integer_v->to_int32() == 0)
+		if (right.is_zero())
 			throw std::domain_error("calc::modulus_expr::value");
 
-		return std::make_unique<integer_value>(left_integer_v->to_int32()
-		                                       % right_integer_v->to_int32());
+		return promote(left % right, "calc::modulus_expr::value");
 	}
 
 	std::unique_ptr<class value> equal_expr::value() const {
 		std::unique_ptr<class value> left_v = this->left_operand()->value();
 		std::unique_ptr<class value> right_v = this->right_operand()->value();
 
-		if (typeid(*left_v) != typeid(*right_v))
+		if (left_v->type() != right_v->type())
 			throw std::invalid_argument("calc::equal_expr::value");
 
 		return std::make_unique<boolean_value>(left_v->is_equal(*right_v));
@@ -163,7 +227,7 @@ namespace calc {
 		std::unique_ptr<class value> left_v = this->left_operand()->value();
 		std::unique_ptr<class value> right_v = this->right_operand()->value();
 
-		if (typeid(*left_v) != typeid(*right_v))
+		if (left_v->type() != right_v->type())
 			throw std::invalid_argument("calc::not_equal_expr::value");
 
 		return std::make_unique<boolean_value>(!left_v->is_equal(*right_v));
@@ -175,11 +239,15 @@ namespace calc {
 		integer_value* left_integer_v = dynamic_cast<integer_value*>(left_v.get());
 		integer_value* right_integer_v = dynamic_cast<integer_value*>(right_v.get());
 
-		if (!left_integer_v || !right_integer_v)
+		if (left_integer_v && right_integer_v)
+			return std::make_unique<boolean_value>(left_integer_v->to_integer()
+			                                       < right_integer_v->to_integer());
+
+		bigint left, right;
+		if (!get_bigint(*left_v, left) || !get_bigint(*right_v, right))
 			throw std::invalid_argument("calc::less_expr::value");
 
-		return std::make_unique<boolean_value>(left_integer_v->to_int32()
-		                                       < right_integer_v->to_int32());
+		return std::make_unique<boolean_value>(left < right);
 	}
 
 	std::unique_ptr<class value> greater_expr::value() const {
@@ -188,11 +256,15 @@ namespace calc {
 		integer_value* left_integer_v = dynamic_cast<integer_value*>(left_v.get());
 		integer_value* right_integer_v = dynamic_cast<integer_value*>(right_v.get());
 
-		if (!left_integer_v || !right_integer_v)
+		if (left_integer_v && right_integer_v)
+			return std::make_unique<boolean_value>(left_integer_v->to_integer()
+			                                       > right_integer_v->to_integer());
+
+		bigint left, right;
+		if (!get_bigint(*left_v, left) || !get_bigint(*right_v, right))
 			throw std::invalid_argument("calc::greater_expr::value");
 
-		return std::make_unique<boolean_value>(left_integer_v->to_int32()
-		                                       > right_integer_v->to_int32());
+		return std::make_unique<boolean_value>(left > right);
 	}
 
 	std::unique_ptr<class value> less_equal_expr::value() const {
@@ -201,11 +273,15 @@ namespace calc {
 		integer_value* left_integer_v = dynamic_cast<integer_value*>(left_v.get());
 		integer_value* right_integer_v = dynamic_cast<integer_value*>(right_v.get());
 
-		if (!left_integer_v || !right_integer_v)
+		if (left_integer_v && right_integer_v)
+			return std::make_unique<boolean_value>(left_integer_v->to_integer()
+			                                       <= right_integer_v->to_integer());
+
+		bigint left, right;
+		if (!get_bigint(*left_v, left) || !get_bigint(*right_v, right))
 			throw std::invalid_argument("calc::less_equal_expr::value");
 
-		return std::make_unique<boolean_value>(left_integer_v->to_int32()
-		                                       <= right_integer_v->to_int32());
+		return std::make_unique<boolean_value>(left <= right);
 	}
 
 	std::unique_ptr<class value> greater_equal_expr::value() const {
@@ -214,11 +290,15 @@ namespace calc {
 		integer_value* left_integer_v = dynamic_cast<integer_value*>(left_v.get());
 		integer_value* right_integer_v = dynamic_cast<integer_value*>(right_v.get());
 
-		if (!left_integer_v || !right_integer_v)
-			throw std::invalid_argument("calc::greater_expr::value");
+		if (left_integer_v && right_integer_v)
+			return std::make_unique<boolean_value>(left_integer_v->to_integer()
+			                                       >= right_integer_v->to_integer());
+
+		bigint left, right;
+		if (!get_bigint(*left_v, left) || !get_bigint(*right_v, right))
+			throw std::invalid_argument("calc::greater_equal_expr::value");
 
-		return std::make_unique<boolean_value>(left_integer_v->to_int32()
-		                                       <= right_integer_v->to_int32());
+		return std::make_unique<boolean_value>(left >= right);
 	}
 
 	std::unique_ptr<class value> logical_not_expr::value() const {
@@ -263,12 +343,153 @@ namespace calc {
 		return std::make_unique<boolean_value>(this->_value);
 	}
 
-	integer::integer(std::int32_t v) noexcept : _value(v) {}
+	bool boolean::to_bool() const noexcept {
+		return this->_value;
+	}
+
+	integer::integer(integer_t v) noexcept : _value(v) {}
 
 	std::unique_ptr<class value> integer::value() const {
 		return std::make_unique<integer_value>(this->_value);
 	}
 
+	integer_t integer::to_integer() const noexcept {
+		return this->_value;
+	}
+
+	error_expr::error_expr(error_id code, std::size_t start_offset,
+	                       std::size_t end_offset) noexcept :
+		_code(code), _start_offset(start_offset), _end_offset(end_offset),
+		_operands()
+	{}
+
+	error_expr::error_expr(error_id code, std::size_t start_offset,
+	                       std::size_t end_offset,
+	                       std::vector<std::unique_ptr<const expr>>&& operands) noexcept :
+		_code(code), _start_offset(start_offset), _end_offset(end_offset),
+		_operands(std::move(operands))
+	{}
+
+	big_integer::big_integer(bigint&& v) noexcept : _value(std::move(v)) {}
+
+	std::unique_ptr<class value> big_integer::value() const {
+		return std::make_unique<bigint_value>(bigint(this->_value));
+	}
+
+	const bigint& big_integer::to_bigint() const noexcept {
+		return this->_value;
+	}
+
+	std::unique_ptr<class value> error_expr::value() const {
+		throw std::invalid_argument("calc::error_expr::value");
+	}
+
+	error_id error_expr::code() const noexcept {
+		return this->_code;
+	}
+
+	std::size_t error_expr::start_offset() const noexcept {
+		return this->_start_offset;
+	}
+
+	std::size_t error_expr::end_offset() const noexcept {
+		return this->_end_offset;
+	}
+
+	const std::vector<std::unique_ptr<const expr>>& error_expr::operands() const noexcept {
+		return this->_operands;
+	}
+
+	#define DEFINE_EXPR_ACCEPT_AND_KIND(CLASS, KIND) \
+		void CLASS::accept(expr_visitor& visitor) const { \
+			visitor.visit(*this); \
+		} \
+		\
+		expr_kind CLASS::kind() const noexcept { \
+			return expr_kind::KIND; \
+		}
+
+	DEFINE_EXPR_ACCEPT_AND_KIND(positive_expr, positive)
+	DEFINE_EXPR_ACCEPT_AND_KIND(negative_expr, negative)
+	DEFINE_EXPR_ACCEPT_AND_KIND(addition_expr, addition)
+	DEFINE_EXPR_ACCEPT_AND_KIND(subtraction_expr, subtraction)
+	DEFINE_EXPR_ACCEPT_AND_KIND(multiplication_expr, multiplication)
+	DEFINE_EXPR_ACCEPT_AND_KIND(division_expr, division)
+	DEFINE_EXPR_ACCEPT_AND_KIND(modulus_expr, modulus)
+	DEFINE_EXPR_ACCEPT_AND_KIND(equal_expr, equal)
+	DEFINE_EXPR_ACCEPT_AND_KIND(not_equal_expr, not_equal)
+	DEFINE_EXPR_ACCEPT_AND_KIND(less_expr, less)
+	DEFINE_EXPR_ACCEPT_AND_KIND(greater_expr, greater)
+	DEFINE_EXPR_ACCEPT_AND_KIND(less_equal_expr, less_equal)
+	DEFINE_EXPR_ACCEPT_AND_KIND(greater_equal_expr, greater_equal)
+	DEFINE_EXPR_ACCEPT_AND_KIND(logical_not_expr, logical_not)
+	DEFINE_EXPR_ACCEPT_AND_KIND(logical_and_expr, logical_and)
+	DEFINE_EXPR_ACCEPT_AND_KIND(logical_or_expr, logical_or)
+	DEFINE_EXPR_ACCEPT_AND_KIND(boolean, boolean)
+	DEFINE_EXPR_ACCEPT_AND_KIND(integer, integer)
+	DEFINE_EXPR_ACCEPT_AND_KIND(error_expr, error)
+	DEFINE_EXPR_ACCEPT_AND_KIND(big_integer, big_integer)
+
+	#undef DEFINE_EXPR_ACCEPT_AND_KIND
+
+	expr_visitor::~expr_visitor() {}
+
+	/**
+	 * Computes the type of an expression from the types of its operands.
+	 */
+	class static_type_visitor : public expr_visitor {
+	public:
+		const class type* result = nullptr;
+
+		void visit(const positive_expr& e) { this->unary(e, integer_type::instance, integer_type::instance); }
+		void visit(const negative_expr& e) { this->unary(e, integer_type::instance, integer_type::instance); }
+		void visit(const addition_expr& e) { this->binary(e, integer_type::instance, integer_type::instance); }
+		void visit(const subtraction_expr& e) { this->binary(e, integer_type::instance, integer_type::instance); }
+		void visit(const multiplication_expr& e) { this->binary(e, integer_type::instance, integer_type::instance); }
+		void visit(const division_expr& e) { this->binary(e, integer_type::instance, integer_type::instance); }
+		void visit(const modulus_expr& e) { this->binary(e, integer_type::instance, integer_type::instance); }
+		void visit(const equal_expr& e) { this->equality(e); }
+		void visit(const not_equal_expr& e) { this->equality(e); }
+		void visit(const less_expr& e) { this->binary(e, integer_type::instance, boolean_type::instance); }
+		void visit(const greater_expr& e) { this->binary(e, integer_type::instance, boolean_type::instance); }
+		void visit(const less_equal_expr& e) { this->binary(e, integer_type::instance, boolean_type::instance); }
+		void visit(const greater_equal_expr& e) { this->binary(e, integer_type::instance, boolean_type::instance); }
+		void visit(const logical_not_expr& e) { this->unary(e, boolean_type::instance, boolean_type::instance); }
+		void visit(const logical_and_expr& e) { this->binary(e, boolean_type::instance, boolean_type::instance); }
+		void visit(const logical_or_expr& e) { this->binary(e, boolean_type::instance, boolean_type::instance); }
+		void visit(const boolean& e) { this->result = &boolean_type::instance; }
+		void visit(const integer& e) { this->result = &integer_type::instance; }
+		void visit(const big_integer& e) { this->result = &integer_type::instance; }
+
+		void visit(const error_expr& e) {
+			throw std::invalid_argument("calc::static_type");
+		}
+
+	private:
+		void unary(const unary_expr& e, const class type& operand_type,
+		           const class type& result_type)
+		{
+			if (static_type(*e.operand()) != operand_type)
+				throw std::invalid_argument("calc::static_type");
+			this->result = &result_type;
+		}
+
+		void binary(const binary_expr& e, const class type& operand_type,
+		            const class type& result_type)
+		{
+			if (static_type(*e.left_operand()) != operand_type
+			    || static_type(*e.right_operand()) != operand_type)
+				throw std::invalid_argument("calc::static_type");
+			this->result = &result_type;
+		}
+
+		void equality(const binary_expr& e) {
+			if (static_type(*e.left_operand()) != static_type(*e.right_operand()))
+				throw std::invalid_argument("calc::static_type");
+			this->result = &boolean_type::instance;
+		}
+	};
+
 	// -----------------------------------------------------------------------
 	// Types
 	// -----------------------------------------------------------------------
@@ -298,6 +519,12 @@ namespace calc {
 
 	integer_type::integer_type() : type("integer") {}
 
+	const type& static_type(const expr& e) {
+		static_type_visitor visitor;
+		e.accept(visitor);
+		return *visitor.result;
+	}
+
 	// -----------------------------------------------------------------------
 	// Values
 	// -----------------------------------------------------------------------
@@ -356,7 +583,7 @@ namespace calc {
 		return this->to_bool() == dynamic_cast<const boolean_value&>(other).to_bool();
 	}
 
-	integer_value::integer_value(std::int32_t v) noexcept :
+	integer_value::integer_value(integer_t v) noexcept :
 		value(integer_type::instance), _data(v)
 	{}
 
@@ -364,7 +591,7 @@ namespace calc {
 		value(other), _data(other._data)
 	{}
 
-	integer_value& integer_value::operator=(std::int32_t v) noexcept {
+	integer_value& integer_value::operator=(integer_t v) noexcept {
 		this->_data = v;
 		return *this;
 	}
@@ -375,8 +602,8 @@ namespace calc {
 	}
 
 	#define DEFINE_INTEGER_COMPOUND_ASSIGNMENT_OPERATOR(OP) \
-		integer_value& integer_value::operator OP##=(std::int32_t v) noexcept { \
-			*this = std::int32_t(*this) OP v; \
+		integer_value& integer_value::operator OP##=(integer_t v) noexcept { \
+			*this = integer_t(*this) OP v; \
 			return *this; \
 		}
 
@@ -415,17 +642,40 @@ namespace calc {
 		return result;
 	}
 
-	std::int32_t integer_value::to_int32() const noexcept {
+	integer_t integer_value::to_integer() const noexcept {
 		return this->_data;
 	}
 
-	integer_value::operator std::int32_t() const noexcept {
+	integer_value::operator integer_t() const noexcept {
 		return this->_data;
 	}
 
 	bool integer_value::do_is_equal(const value& other) const noexcept {
 		if (typeid(other) != typeid(integer_value))
 			return false;
-		return this->to_int32() == dynamic_cast<const integer_value&>(other).to_int32();
+		return this->to_integer() == dynamic_cast<const integer_value&>(other).to_integer();
+	}
+
+	bigint_value::bigint_value(bigint&& v) noexcept :
+		value(integer_type::instance), _data(std::move(v))
+	{}
+
+	bigint_value::bigint_value(const bigint_value& other) :
+		value(other), _data(other._data)
+	{}
+
+	bigint_value& bigint_value::operator=(const bigint_value& other) {
+		this->_data = other._data;
+		return *this;
+	}
+
+	const bigint& bigint_value::to_bigint() const noexcept {
+		return this->_data;
+	}
+
+	bool bigint_value::do_is_equal(const value& other) const noexcept {
+		if (typeid(other) != typeid(bigint_value))
+			return false;
+		return this->to_bigint() == dynamic_cast<const bigint_value&>(other).to_bigint();
 	}
 } // namespace calc
@@ -12,10 +12,16 @@
 
 #include "config.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <ostream>
 #include <string>
+#include <vector>
+
+#include "bigint.hpp"
+#include "constants.hpp"
+#include "integer_policy.hpp"
 
 namespace calc {
 	class expr;
@@ -39,6 +45,8 @@ namespace calc {
 	class logical_or_expr;
 	class boolean;
 	class integer;
+	class error_expr;
+	class big_integer;
 
 	class type;
 	class boolean_type;
@@ -47,6 +55,9 @@ namespace calc {
 	class value;
 	class boolean_value;
 	class integer_value;
+	class bigint_value;
+
+	class expr_visitor;
 
 	/**
 	 * Represents an expression.
@@ -55,6 +66,8 @@ namespace calc {
 	public:
 		virtual ~expr() = 0;
 		virtual std::unique_ptr<class value> value() const = 0;
+		virtual void accept(expr_visitor& visitor) const = 0;
+		virtual expr_kind kind() const noexcept = 0;
 	};
 
 	/**
@@ -97,6 +110,8 @@ namespace calc {
 	public:
 		using unary_expr::unary_expr;
 		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
 	};
 
 	/**
@@ -106,6 +121,8 @@ namespace calc {
 	public:
 		using unary_expr::unary_expr;
 		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
 	};
 
 	/**
@@ -115,6 +132,8 @@ namespace calc {
 	public:
 		using binary_expr::binary_expr;
 		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
 	};
 
 	/**
@@ -124,6 +143,8 @@ namespace calc {
 	public:
 		using binary_expr::binary_expr;
 		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
 	};
 
 	/**
@@ -133,6 +154,8 @@ namespace calc {
 	public:
 		using binary_expr::binary_expr;
 		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
 	};
 
 	/**
@@ -142,6 +165,8 @@ namespace calc {
 	public:
 		using binary_expr::binary_expr;
 		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
 	};
 
 	/**
@@ -151,6 +176,8 @@ namespace calc {
 	public:
 		using binary_expr::binary_expr;
 		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
 	};
 
 	/**
@@ -160,6 +187,8 @@ namespace calc {
 	public:
 		using binary_expr::binary_expr;
 		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
 	};
 
 	/**
@@ -169,6 +198,8 @@ namespace calc {
 	public:
 		using binary_expr::binary_expr;
 		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
 	};
 
 	/**
@@ -178,6 +209,8 @@ namespace calc {
 	public:
 		using binary_expr::binary_expr;
 		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
 	};
 
 	/**
@@ -187,6 +220,8 @@ namespace calc {
 	public:
 		using binary_expr::binary_expr;
 		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
 	};
 
 	/**
@@ -196,6 +231,8 @@ namespace calc {
 	public:
 		using binary_expr::binary_expr;
 		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
 	};
 
 	/**
@@ -205,6 +242,8 @@ namespace calc {
 	public:
 		using binary_expr::binary_expr;
 		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
 	};
 
 	/**
@@ -214,6 +253,8 @@ namespace calc {
 	public:
 		using unary_expr::unary_expr;
 		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
 	};
 
 	/**
@@ -223,6 +264,8 @@ namespace calc {
 	public:
 		using binary_expr::binary_expr;
 		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
 	};
 
 	/**
@@ -232,6 +275,8 @@ namespace calc {
 	public:
 		using binary_expr::binary_expr;
 		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
 	};
 
 	/**
@@ -241,6 +286,10 @@ namespace calc {
 	public:
 		explicit boolean(bool v) noexcept;
 		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
+
+		bool to_bool() const noexcept;
 
 	private:
 		bool _value;
@@ -251,11 +300,93 @@ namespace calc {
 	 */
 	class integer : public expr {
 	public:
-		explicit integer(std::int32_t v) noexcept;
+		explicit integer(integer_t v) noexcept;
+		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
+
+		integer_t to_integer() const noexcept;
+
+	private:
+		integer_t _value;
+	};
+
+	/**
+	 * Represents the part of an expression that has a syntax error, in a
+	 * tree built by a parser that recovers from errors. The operands are
+	 * the subexpressions that could still be parsed around the error. An
+	 * error expression has neither a value nor a type.
+	 */
+	class error_expr : public expr {
+	public:
+		error_expr(error_id code, std::size_t start_offset,
+		           std::size_t end_offset) noexcept;
+		error_expr(error_id code, std::size_t start_offset,
+		           std::size_t end_offset,
+		           std::vector<std::unique_ptr<const expr>>&& operands) noexcept;
 		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
+
+		error_id code() const noexcept;
+		std::size_t start_offset() const noexcept;
+		std::size_t end_offset() const noexcept;
+		const std::vector<std::unique_ptr<const expr>>& operands() const noexcept;
 
 	private:
-		std::int32_t _value;
+		error_id _code;
+		std::size_t _start_offset;
+		std::size_t _end_offset;
+		std::vector<std::unique_ptr<const expr>> _operands;
+	};
+
+	/**
+	 * Represents an integer literal expression whose value is outside the
+	 * range of integer_t. The parser makes one only in builds with
+	 * ENABLE_BIGINT.
+	 */
+	class big_integer : public expr {
+	public:
+		explicit big_integer(bigint&& v) noexcept;
+		std::unique_ptr<class value> value() const;
+		void accept(expr_visitor& visitor) const;
+		expr_kind kind() const noexcept;
+
+		const bigint& to_bigint() const noexcept;
+
+	private:
+		bigint _value;
+	};
+
+	/**
+	 * Represents an operation on each kind of expression. Classes that
+	 * traverse an abstract syntax tree derive from this class and override
+	 * the visit() function for each kind of expression.
+	 */
+	class expr_visitor {
+	public:
+		virtual ~expr_visitor();
+
+		virtual void visit(const positive_expr& e) = 0;
+		virtual void visit(const negative_expr& e) = 0;
+		virtual void visit(const addition_expr& e) = 0;
+		virtual void visit(const subtraction_expr& e) = 0;
+		virtual void visit(const multiplication_expr& e) = 0;
+		virtual void visit(const division_expr& e) = 0;
+		virtual void visit(const modulus_expr& e) = 0;
+		virtual void visit(const equal_expr& e) = 0;
+		virtual void visit(const not_equal_expr& e) = 0;
+		virtual void visit(const less_expr& e) = 0;
+		virtual void visit(const greater_expr& e) = 0;
+		virtual void visit(const less_equal_expr& e) = 0;
+		virtual void visit(const greater_equal_expr& e) = 0;
+		virtual void visit(const logical_not_expr& e) = 0;
+		virtual void visit(const logical_and_expr& e) = 0;
+		virtual void visit(const logical_or_expr& e) = 0;
+		virtual void visit(const boolean& e) = 0;
+		virtual void visit(const integer& e) = 0;
+		virtual void visit(const error_expr& e) = 0;
+		virtual void visit(const big_integer& e) = 0;
 	};
 
 	/**
@@ -313,6 +444,14 @@ namespace calc {
 		integer_type();
 	};
 
+	/**
+	 * Determines the type of an expression without evaluating it.
+	 * @param e	An expression.
+	 * @return	The type of the value that @p e evaluates to.
+	 * @throw	std::invalid_argument if an operand of @p e has the wrong type.
+	 */
+	const type& static_type(const expr& e);
+
 	/**
 	 * Represents a value.
 	 */
@@ -363,14 +502,14 @@ namespace calc {
 	 */
 	class integer_value : public value {
 	public:
-		integer_value(std::int32_t v = std::int32_t()) noexcept;
+		integer_value(integer_t v = integer_t()) noexcept;
 		integer_value(const integer_value& other) noexcept;
 
-		integer_value& operator=(std::int32_t v) noexcept;
+		integer_value& operator=(integer_t v) noexcept;
 		integer_value& operator=(const integer_value& other) noexcept;
 
 		#define DECLARE_INTEGER_COMPOUND_ASSIGNMENT_OPERATOR(OP) \
-			integer_value& operator OP##=(std::int32_t v) noexcept;
+			integer_value& operator OP##=(integer_t v) noexcept;
 
 		DECLARE_INTEGER_COMPOUND_ASSIGNMENT_OPERATOR(+)
 		DECLARE_INTEGER_COMPOUND_ASSIGNMENT_OPERATOR(-)
@@ -390,14 +529,36 @@ namespace calc {
 		integer_value& operator--() noexcept;
 		integer_value operator--(int) noexcept;
 
-		std::int32_t to_int32() const noexcept;
-		operator std::int32_t() const noexcept;
+		integer_t to_integer() const noexcept;
+		operator integer_t() const noexcept;
+
+	protected:
+		virtual bool do_is_equal(const value& other) const noexcept;
+
+	private:
+		integer_t _data;
+	};
+
+	/**
+	 * Represents an integer value that is outside the range of integer_t.
+	 * In builds with ENABLE_BIGINT, integer arithmetic whose result would
+	 * overflow integer_t makes a bigint_value instead, and a result that
+	 * fits makes an integer_value, so each integer has one representation.
+	 */
+	class bigint_value : public value {
+	public:
+		explicit bigint_value(bigint&& v) noexcept;
+		bigint_value(const bigint_value& other);
+
+		bigint_value& operator=(const bigint_value& other);
+
+		const bigint& to_bigint() const noexcept;
 
 	protected:
 		virtual bool do_is_equal(const value& other) const noexcept;
 
 	private:
-		std::int32_t _data;
+		bigint _data;
 	};
 
 	template <typename CharT, class Traits>
@@ -405,8 +566,10 @@ namespace calc {
 	operator<<(std::basic_ostream<CharT, Traits>& out, const value& v) {
 		if (v.type() == boolean_type::instance)
 			return out << dynamic_cast<const boolean_value&>(v).to_bool();
-		if (v.type() == integer_type::instance)
-			return out << dynamic_cast<const integer_value&>(v).to_int32();
+		if (const integer_value* integer_v = dynamic_cast<const integer_value*>(&v))
+			return write_integer(out, integer_v->to_integer());
+		if (const bigint_value* bigint_v = dynamic_cast<const bigint_value*>(&v))
+			return out << bigint_v->to_bigint();
 		return out;
 	}
 } // namespace calc
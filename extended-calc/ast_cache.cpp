@@ -0,0 +1,389 @@
+/**
+ * @file		ast_cache.cpp
+ * Contains type definitions for the binary abstract syntax tree cache.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#include "ast_cache.hpp"
+
+#include <cstring>
+#include <fstream>
+#if HAVE_SYS_MMAN_H
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace calc {
+	static const char ast_cache_magic[8] = {'C', 'A', 'L', 'C', 'A', 'S', 'T', '\0'};
+	static const std::uint32_t ast_cache_byte_order = 0x01020304;
+
+	static const std::uint64_t fnv1a_offset_basis = 0xcbf29ce484222325ULL;
+	static const std::uint64_t fnv1a_prime = 0x100000001b3ULL;
+
+	static std::uint64_t fnv1a(const void* data, std::size_t size,
+	                           std::uint64_t hash = fnv1a_offset_basis)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (std::size_t i = 0; i < size; i++) {
+			hash ^= bytes[i];
+			hash *= fnv1a_prime;
+		}
+		return hash;
+	}
+
+	/**
+	 * Appends the nodes of an expression to a node array in postfix order.
+	 */
+	class ast_cache_node_builder : public expr_visitor {
+	public:
+		explicit ast_cache_node_builder(std::vector<ast_cache_node>& nodes) :
+			_nodes(nodes)
+		{}
+
+		void build(const expr& e) {
+			e.accept(*this);
+		}
+
+		void visit(const positive_expr& e) { this->unary(e); }
+		void visit(const negative_expr& e) { this->unary(e); }
+		void visit(const addition_expr& e) { this->binary(e); }
+		void visit(const subtraction_expr& e) { this->binary(e); }
+		void visit(const multiplication_expr& e) { this->binary(e); }
+		void visit(const division_expr& e) { this->binary(e); }
+		void visit(const modulus_expr& e) { this->binary(e); }
+		void visit(const equal_expr& e) { this->binary(e); }
+		void visit(const not_equal_expr& e) { this->binary(e); }
+		void visit(const less_expr& e) { this->binary(e); }
+		void visit(const greater_expr& e) { this->binary(e); }
+		void visit(const less_equal_expr& e) { this->binary(e); }
+		void visit(const greater_equal_expr& e) { this->binary(e); }
+		void visit(const logical_not_expr& e) { this->unary(e); }
+		void visit(const logical_and_expr& e) { this->binary(e); }
+		void visit(const logical_or_expr& e) { this->binary(e); }
+
+		void visit(const boolean& e) {
+			this->append(e.kind(), e.to_bool());
+		}
+
+		void visit(const integer& e) {
+			// the format holds 32-bit literals, whatever the integer width
+			if (e.to_integer() < INT32_MIN || e.to_integer() > INT32_MAX)
+				throw ast_cache_error("calc::ast_cache_writer::add");
+			this->append(e.kind(), static_cast<std::uint32_t>(e.to_integer()));
+		}
+
+		void visit(const error_expr& e) {
+			// a tree with syntax errors is never worth caching
+			throw ast_cache_error("calc::ast_cache_writer::add");
+		}
+
+		void visit(const big_integer& e) {
+			throw ast_cache_error("calc::ast_cache_writer::add");
+		}
+
+	private:
+		std::vector<ast_cache_node>& _nodes;
+
+		void append(expr_kind kind, std::uint32_t data) {
+			ast_cache_node node = {};
+			node.kind = static_cast<std::uint8_t>(kind);
+			node.data = data;
+			this->_nodes.push_back(node);
+		}
+
+		void unary(const unary_expr& e) {
+			this->build(*e.operand());
+			this->append(e.kind(), 0);
+		}
+
+		void binary(const binary_expr& e) {
+			this->build(*e.left_operand());
+			const std::size_t left_index = this->_nodes.size() - 1;
+			this->build(*e.right_operand());
+			const std::size_t distance = this->_nodes.size() - left_index;
+			if (distance > UINT32_MAX)
+				throw ast_cache_error("calc::ast_cache_writer::add");
+			this->append(e.kind(), static_cast<std::uint32_t>(distance));
+		}
+	};
+
+	const std::uint16_t ast_cache_writer::version = 1;
+
+	ast_cache_writer::ast_cache_writer(bool with_extents) :
+		_with_extents(with_extents), _root_ends(), _extents(), _nodes()
+	{}
+
+	void ast_cache_writer::add(const expr& e, std::size_t start_offset,
+	                           std::size_t end_offset)
+	{
+		ast_cache_node_builder builder(this->_nodes);
+		builder.build(e);
+		this->_root_ends.push_back(this->_nodes.size());
+		if (this->_with_extents) {
+			this->_extents.push_back(start_offset);
+			this->_extents.push_back(end_offset);
+		}
+	}
+
+	void ast_cache_writer::write(std::ostream& out) const {
+		const std::size_t root_ends_size = this->_root_ends.size() * sizeof(std::uint64_t);
+		const std::size_t extents_size = this->_extents.size() * sizeof(std::uint64_t);
+		const std::size_t nodes_size = this->_nodes.size() * sizeof(ast_cache_node);
+
+		ast_cache_header header = {};
+		std::memcpy(header.magic, ast_cache_magic, sizeof(header.magic));
+		header.byte_order = ast_cache_byte_order;
+		header.version = version;
+		header.flags = static_cast<std::uint16_t>(this->_with_extents ? ast_cache_flags::has_extents : ast_cache_flags::none);
+		header.root_count = this->_root_ends.size();
+		header.node_count = this->_nodes.size();
+		header.checksum = fnv1a(this->_root_ends.data(), root_ends_size);
+		header.checksum = fnv1a(this->_extents.data(), extents_size, header.checksum);
+		header.checksum = fnv1a(this->_nodes.data(), nodes_size, header.checksum);
+
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.write(reinterpret_cast<const char*>(this->_root_ends.data()), root_ends_size);
+		out.write(reinterpret_cast<const char*>(this->_extents.data()), extents_size);
+		out.write(reinterpret_cast<const char*>(this->_nodes.data()), nodes_size);
+	}
+
+	void ast_cache_writer::write(const std::string& path) const {
+		std::ofstream out(path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+		if (!out)
+			throw ast_cache_error("Could not open " + path + ".");
+		this->write(out);
+		out.close();
+		if (!out)
+			throw ast_cache_error("Could not write " + path + ".");
+	}
+
+	ast_cache_reader::ast_cache_reader(const std::string& path) :
+		_image(nullptr), _image_size(0), _buffer(), _root_count(0),
+		_root_ends(nullptr), _extents(nullptr), _nodes(nullptr),
+		_node_count(0), _stack()
+	{
+#if HAVE_SYS_MMAN_H
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			throw ast_cache_error("Could not open " + path + ".");
+
+		struct stat st;
+		if (::fstat(fd, &st) < 0) {
+			::close(fd);
+			throw ast_cache_error("Could not read " + path + ".");
+		}
+		this->_image_size = st.st_size;
+
+		if (this->_image_size > 0) {
+			void* image = ::mmap(nullptr, this->_image_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (image == MAP_FAILED) {
+				::close(fd);
+				throw ast_cache_error("Could not map " + path + ".");
+			}
+			this->_image = static_cast<const unsigned char*>(image);
+		}
+		::close(fd);
+#else
+		std::ifstream in(path, std::ios_base::in | std::ios_base::binary);
+		if (!in)
+			throw ast_cache_error("Could not open " + path + ".");
+		in.seekg(0, std::ios_base::end);
+		this->_image_size = static_cast<std::size_t>(in.tellg());
+		in.seekg(0, std::ios_base::beg);
+		this->_buffer.resize((this->_image_size + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+		if (!in.read(reinterpret_cast<char*>(this->_buffer.data()), this->_image_size))
+			throw ast_cache_error("Could not read " + path + ".");
+		this->_image = reinterpret_cast<const unsigned char*>(this->_buffer.data());
+#endif
+
+		try {
+			this->validate(path);
+		}
+		catch (...) {
+#if HAVE_SYS_MMAN_H
+			if (this->_image)
+				::munmap(const_cast<unsigned char*>(this->_image), this->_image_size);
+#endif
+			throw;
+		}
+	}
+
+	ast_cache_reader::~ast_cache_reader() {
+#if HAVE_SYS_MMAN_H
+		if (this->_image)
+			::munmap(const_cast<unsigned char*>(this->_image), this->_image_size);
+#endif
+	}
+
+	void ast_cache_reader::validate(const std::string& path) {
+		const std::string invalid = path + " is not a valid AST cache file.";
+
+		if (this->_image_size < sizeof(ast_cache_header))
+			throw ast_cache_error(invalid);
+
+		const ast_cache_header* header = reinterpret_cast<const ast_cache_header*>(this->_image);
+		if (std::memcmp(header->magic, ast_cache_magic, sizeof(header->magic)) != 0
+		    || header->byte_order != ast_cache_byte_order)
+			throw ast_cache_error(invalid);
+		if (header->version != ast_cache_writer::version)
+			throw ast_cache_error(path + " was written by an incompatible version.");
+
+		const bool has_extents = (header->flags & static_cast<std::uint16_t>(ast_cache_flags::has_extents)) != 0;
+		const std::size_t body_size = this->_image_size - sizeof(ast_cache_header);
+		const std::size_t root_size = sizeof(std::uint64_t) * (has_extents ? 3 : 1);
+
+		// check each count separately first so that the size computation
+		// below cannot overflow
+		if (header->root_count > body_size / root_size
+		    || header->node_count > body_size / sizeof(ast_cache_node)
+		    || header->root_count * root_size + header->node_count * sizeof(ast_cache_node) != body_size)
+			throw ast_cache_error(invalid);
+
+		if (fnv1a(this->_image + sizeof(ast_cache_header), body_size) != header->checksum)
+			throw ast_cache_error(path + " failed checksum validation.");
+
+		this->_root_count = header->root_count;
+		this->_node_count = header->node_count;
+		this->_root_ends = reinterpret_cast<const std::uint64_t*>(this->_image + sizeof(ast_cache_header));
+		if (has_extents)
+			this->_extents = this->_root_ends + this->_root_count;
+		this->_nodes = reinterpret_cast<const ast_cache_node*>(this->_root_ends + this->_root_count * (has_extents ? 3 : 1));
+
+		for (std::size_t i = 0; i < this->_root_count; i++)
+			if (this->_root_ends[i] > this->_node_count
+			    || (i > 0 && this->_root_ends[i] <= this->_root_ends[i - 1]))
+				throw ast_cache_error(invalid);
+	}
+
+	std::size_t ast_cache_reader::start_offset(std::size_t i) const noexcept {
+		return this->has_extents() ? this->_extents[2 * i] : 0;
+	}
+
+	std::size_t ast_cache_reader::end_offset(std::size_t i) const noexcept {
+		return this->has_extents() ? this->_extents[2 * i + 1] : 0;
+	}
+
+	std::unique_ptr<class value> ast_cache_reader::value(std::size_t i) const {
+		const std::size_t begin = i > 0 ? this->_root_ends[i - 1] : 0;
+		const std::size_t end = this->_root_ends[i];
+		std::vector<slot>& stack = this->_stack;
+
+		stack.clear();
+
+		for (std::size_t j = begin; j < end; j++) {
+			const ast_cache_node& node = this->_nodes[j];
+			const expr_kind kind = static_cast<expr_kind>(node.kind);
+
+			switch (kind) {
+				case expr_kind::boolean:
+					stack.push_back({true, node.data != 0});
+					continue;
+				case expr_kind::integer:
+					stack.push_back({false, static_cast<std::int32_t>(node.data)});
+					continue;
+				case expr_kind::positive:
+				case expr_kind::negative:
+				case expr_kind::logical_not: {
+					if (stack.empty())
+						throw ast_cache_error("calc::ast_cache_reader::value");
+					slot& operand = stack.back();
+					if (operand.is_boolean != (kind == expr_kind::logical_not))
+						throw std::invalid_argument("calc::ast_cache_reader::value");
+					if (kind == expr_kind::negative) {
+						if (default_integer_policy::negate(operand.data, operand.data))
+							throw std::overflow_error("calc::ast_cache_reader::value");
+					}
+					else if (kind == expr_kind::logical_not)
+						operand.data = !operand.data;
+					continue;
+				}
+				default:
+					break;
+			}
+
+			if (stack.size() < 2 || node.kind > static_cast<std::uint8_t>(expr_kind::integer))
+				throw ast_cache_error("calc::ast_cache_reader::value");
+
+			const slot right = stack.back();
+			stack.pop_back();
+			slot& left = stack.back();
+
+			switch (kind) {
+				case expr_kind::equal:
+				case expr_kind::not_equal:
+					if (left.is_boolean != right.is_boolean)
+						throw std::invalid_argument("calc::ast_cache_reader::value");
+					left.data = (left.data == right.data) == (kind == expr_kind::equal);
+					left.is_boolean = true;
+					continue;
+				case expr_kind::logical_and:
+				case expr_kind::logical_or:
+					if (!left.is_boolean || !right.is_boolean)
+						throw std::invalid_argument("calc::ast_cache_reader::value");
+					left.data = kind == expr_kind::logical_and ? left.data && right.data
+					                                           : left.data || right.data;
+					continue;
+				default:
+					break;
+			}
+
+			if (left.is_boolean || right.is_boolean)
+				throw std::invalid_argument("calc::ast_cache_reader::value");
+
+			bool overflow = false;
+			switch (kind) {
+				case expr_kind::addition:
+					overflow = default_integer_policy::add(left.data, right.data, left.data);
+					break;
+				case expr_kind::subtraction:
+					overflow = default_integer_policy::subtract(left.data, right.data, left.data);
+					break;
+				case expr_kind::multiplication:
+					overflow = default_integer_policy::multiply(left.data, right.data, left.data);
+					break;
+				case expr_kind::division:
+					if (right.data == 0)
+						throw std::domain_error("calc::ast_cache_reader::value");
+					overflow = default_integer_policy::divide(left.data, right.data, left.data);
+					break;
+				case expr_kind::modulus:
+					if (right.data == 0)
+						throw std::domain_error("calc::ast_cache_reader::value");
+					overflow = default_integer_policy::modulo(left.data, right.data, left.data);
+					break;
+				case expr_kind::less:
+					left.data = left.data < right.data;
+					left.is_boolean = true;
+					break;
+				case expr_kind::greater:
+					left.data = left.data > right.data;
+					left.is_boolean = true;
+					break;
+				case expr_kind::less_equal:
+					left.data = left.data <= right.data;
+					left.is_boolean = true;
+					break;
+				case expr_kind::greater_equal:
+					left.data = left.data >= right.data;
+					left.is_boolean = true;
+					break;
+				default:
+					throw ast_cache_error("calc::ast_cache_reader::value");
+			}
+			if (overflow)
+				throw std::overflow_error("calc::ast_cache_reader::value");
+		}
+
+		if (stack.size() != 1)
+			throw ast_cache_error("calc::ast_cache_reader::value");
+
+		if (stack.back().is_boolean)
+			return std::make_unique<boolean_value>(stack.back().data != 0);
+		return std::make_unique<integer_value>(stack.back().data);
+	}
+} // namespace calc
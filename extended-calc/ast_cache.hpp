@@ -0,0 +1,209 @@
+/**
+ * @file		ast_cache.hpp
+ * Contains type declarations for the binary abstract syntax tree cache.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_AST_CACHE_HPP
+#define CALC_AST_CACHE_HPP
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ast.hpp"
+
+namespace calc {
+	/*
+	 * An AST cache file consists of the following parts, each aligned to
+	 * eight bytes and stored in host byte order:
+	 *
+	 *   ast_cache_header   header
+	 *   std::uint64_t      root_ends[header.root_count]
+	 *   std::uint64_t      extents[2 * header.root_count]  (if has_extents)
+	 *   ast_cache_node     nodes[header.node_count]
+	 *
+	 * The nodes of each expression are stored in postfix order, and the
+	 * nodes of root i are nodes[root_ends[i - 1]] up to (but not including)
+	 * nodes[root_ends[i]]. The operand of a unary node is the node right
+	 * before it; the right operand of a binary node is the node right before
+	 * it, and its left operand is ast_cache_node::data nodes before it.
+	 * Literal nodes store their value in ast_cache_node::data. No part of
+	 * the file contains a pointer, so it can be mapped at any address.
+	 *
+	 * The checksum is the 64-bit FNV-1a hash of everything after the header.
+	 */
+
+	/// Flags that describe the contents of an AST cache file.
+	enum class ast_cache_flags : std::uint16_t {
+		none = 0,
+		has_extents = 1 << 0
+	};
+
+	/**
+	 * The header at the beginning of an AST cache file.
+	 */
+	struct ast_cache_header {
+		/// The file signature, "CALCAST" followed by a null character.
+		char magic[8];
+		/// The value 0x01020304, which identifies the byte order.
+		std::uint32_t byte_order;
+		/// The format version.
+		std::uint16_t version;
+		/// A combination of ast_cache_flags values.
+		std::uint16_t flags;
+		std::uint64_t root_count;
+		std::uint64_t node_count;
+		std::uint64_t checksum;
+	};
+
+	/**
+	 * A single expression node in an AST cache file.
+	 */
+	struct ast_cache_node {
+		/// An expr_kind value.
+		std::uint8_t kind;
+		std::uint8_t reserved[3];
+		/// The value of a literal, or the distance to the left operand of a
+		/// binary expression.
+		std::uint32_t data;
+	};
+
+	/**
+	 * Defines the type of exception object thrown when an AST cache file
+	 * cannot be written or loaded.
+	 */
+	class ast_cache_error : public std::runtime_error {
+	public:
+		using std::runtime_error::runtime_error;
+	};
+
+	/**
+	 * Accumulates expressions and writes them as an AST cache file.
+	 */
+	class ast_cache_writer {
+	public:
+		/// The current format version.
+		static const std::uint16_t version;
+
+		/**
+		 * Constructs an empty writer.
+		 * @param with_extents	@c true if the source extent of each
+		 * 						expression should be stored.
+		 */
+		explicit ast_cache_writer(bool with_extents = false);
+
+		/**
+		 * Appends an expression.
+		 * @param e				An expression.
+		 * @param start_offset	The offset of the beginning of @p e in the
+		 * 						script. Ignored if extents are not stored.
+		 * @param end_offset	The offset of the end of @p e in the script.
+		 * 						Ignored if extents are not stored.
+		 * @throw				ast_cache_error if @p e has a syntax error
+		 * 						or a literal that does not fit in 32 bits.
+		 */
+		void add(const expr& e, std::size_t start_offset = 0,
+		         std::size_t end_offset = 0);
+
+		/**
+		 * Writes every appended expression to an output stream.
+		 * @param out	A binary output stream.
+		 */
+		void write(std::ostream& out) const;
+
+		/**
+		 * Writes every appended expression to a file.
+		 * @param path	The path of the file.
+		 * @throw		ast_cache_error if the file cannot be written.
+		 */
+		void write(const std::string& path) const;
+
+		std::size_t size() const noexcept {
+			return this->_root_ends.size();
+		}
+
+	private:
+		bool _with_extents;
+		std::vector<std::uint64_t> _root_ends;
+		std::vector<std::uint64_t> _extents;
+		std::vector<ast_cache_node> _nodes;
+	};
+
+	/**
+	 * Provides read-only access to a memory-mapped AST cache file.
+	 * Expressions are evaluated directly from the mapped nodes.
+	 */
+	class ast_cache_reader {
+	public:
+		/**
+		 * Maps an AST cache file into memory and validates it.
+		 * @param path	The path of the file.
+		 * @throw		ast_cache_error if the file cannot be read, is not an
+		 * 				AST cache file, or fails checksum validation.
+		 */
+		explicit ast_cache_reader(const std::string& path);
+
+		ast_cache_reader(const ast_cache_reader&) = delete;
+		~ast_cache_reader();
+
+		ast_cache_reader& operator=(const ast_cache_reader&) = delete;
+
+		/**
+		 * Returns the number of expressions in the file.
+		 * @return	The number of expressions in the file.
+		 */
+		std::size_t size() const noexcept {
+			return this->_root_count;
+		}
+
+		bool has_extents() const noexcept {
+			return this->_extents != nullptr;
+		}
+
+		std::size_t start_offset(std::size_t i) const noexcept;
+		std::size_t end_offset(std::size_t i) const noexcept;
+
+		/**
+		 * Evaluates an expression.
+		 * @param i		The index of the expression.
+		 * @return		The value of the expression.
+		 * @throw		std::invalid_argument if an operand has the wrong type.
+		 * @throw		std::domain_error on division by zero.
+		 * @throw		std::overflow_error if a checked integer operation
+		 * 				overflows.
+		 */
+		std::unique_ptr<class value> value(std::size_t i) const;
+
+	private:
+		/// An evaluated operand.
+		struct slot {
+			bool is_boolean;
+			integer_t data;
+		};
+
+		const unsigned char* _image;
+		std::size_t _image_size;
+		/// Holds the image if the file could not be mapped.
+		std::vector<std::uint64_t> _buffer;
+		std::size_t _root_count;
+		const std::uint64_t* _root_ends;
+		const std::uint64_t* _extents;
+		const ast_cache_node* _nodes;
+		std::size_t _node_count;
+		mutable std::vector<slot> _stack;
+
+		void validate(const std::string& path);
+	};
+} // namespace calc
+
+#endif // CALC_AST_CACHE_HPP
@@ -0,0 +1,325 @@
+/**
+ * @file		batch_evaluator.cpp
+ * Contains type definitions for evaluating many expressions at once.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#include "batch_evaluator.hpp"
+
+#include <stdexcept>
+
+namespace calc {
+	/**
+	 * Appends the kinds of the nodes of an expression, in postfix order,
+	 * and the values of its literals.
+	 */
+	class batch_evaluator::flattener : public expr_visitor {
+	public:
+		flattener(std::string& kinds, std::vector<integer_t>& literals) :
+			_kinds(kinds), _literals(literals)
+		{}
+
+		void flatten(const expr& e) {
+			e.accept(*this);
+		}
+
+		void visit(const positive_expr& e) { this->unary(e); }
+		void visit(const negative_expr& e) { this->unary(e); }
+		void visit(const addition_expr& e) { this->binary(e); }
+		void visit(const subtraction_expr& e) { this->binary(e); }
+		void visit(const multiplication_expr& e) { this->binary(e); }
+		void visit(const division_expr& e) { this->binary(e); }
+		void visit(const modulus_expr& e) { this->binary(e); }
+		void visit(const equal_expr& e) { this->binary(e); }
+		void visit(const not_equal_expr& e) { this->binary(e); }
+		void visit(const less_expr& e) { this->binary(e); }
+		void visit(const greater_expr& e) { this->binary(e); }
+		void visit(const less_equal_expr& e) { this->binary(e); }
+		void visit(const greater_equal_expr& e) { this->binary(e); }
+		void visit(const logical_not_expr& e) { this->unary(e); }
+		void visit(const logical_and_expr& e) { this->binary(e); }
+		void visit(const logical_or_expr& e) { this->binary(e); }
+
+		void visit(const boolean& e) {
+			this->_kinds.push_back(static_cast<char>(e.kind()));
+			this->_literals.push_back(e.to_bool());
+		}
+
+		void visit(const integer& e) {
+			this->_kinds.push_back(static_cast<char>(e.kind()));
+			this->_literals.push_back(e.to_integer());
+		}
+
+		void visit(const error_expr& e) {
+			throw std::invalid_argument("calc::batch_evaluator::add");
+		}
+
+		void visit(const big_integer& e) {
+			// the lanes hold integer_t
+			throw std::overflow_error("calc::batch_evaluator::add");
+		}
+
+	private:
+		std::string& _kinds;
+		std::vector<integer_t>& _literals;
+
+		void unary(const unary_expr& e) {
+			this->flatten(*e.operand());
+			this->_kinds.push_back(static_cast<char>(e.kind()));
+		}
+
+		void binary(const binary_expr& e) {
+			this->flatten(*e.left_operand());
+			this->flatten(*e.right_operand());
+			this->_kinds.push_back(static_cast<char>(e.kind()));
+		}
+	};
+
+	batch_evaluator::batch_evaluator() :
+		_groups(), _group_indexes(), _active_groups(), _size(0), _results(), _kinds(),
+		_literals(), _scratch(), _errors(), _stack()
+	{}
+
+	std::size_t batch_evaluator::add(const expr& e) {
+		this->_kinds.clear();
+		this->_literals.clear();
+		flattener f(this->_kinds, this->_literals);
+		f.flatten(e);
+
+		auto it = this->_group_indexes.find(this->_kinds);
+		if (it == this->_group_indexes.end()) {
+			it = this->_group_indexes.emplace(this->_kinds, this->_groups.size()).first;
+			this->_groups.emplace_back();
+			this->_groups.back().kinds = this->_kinds;
+			this->_groups.back().literal_count = this->_literals.size();
+		}
+
+		group& g = this->_groups[it->second];
+		if (g.members.empty())
+			this->_active_groups.push_back(it->second);
+		g.literals.insert(g.literals.end(), this->_literals.begin(), this->_literals.end());
+		g.members.push_back(this->_size);
+		return this->_size++;
+	}
+
+	void batch_evaluator::evaluate() {
+		this->_results.assign(this->_size, result{result_state::none, 0});
+		for (std::size_t i : this->_active_groups)
+			this->evaluate(this->_groups[i]);
+	}
+
+	void batch_evaluator::evaluate(group& g) {
+		const std::size_t n = g.members.size();
+		std::vector<result_state>& errors = this->_errors;
+		std::vector<operand>& stack = this->_stack;
+		std::size_t literal_index = 0;
+		std::size_t scratch_index = 0;
+		bool type_error = false;
+
+		errors.assign(n, result_state::none);
+		stack.clear();
+
+		for (const char c : g.kinds) {
+			const expr_kind kind = static_cast<expr_kind>(c);
+
+			if (scratch_index == this->_scratch.size())
+				this->_scratch.emplace_back();
+			std::vector<integer_t>& column = this->_scratch[scratch_index++];
+			column.resize(n);
+			integer_t* const out = column.data();
+
+			if (kind == expr_kind::boolean || kind == expr_kind::integer) {
+				const integer_t* const literals = g.literals.data() + literal_index++;
+				for (std::size_t i = 0; i < n; i++)
+					out[i] = literals[i * g.literal_count];
+				stack.push_back({out, kind == expr_kind::boolean});
+				continue;
+			}
+
+			switch (kind) {
+				case expr_kind::positive:
+				case expr_kind::negative:
+				case expr_kind::logical_not: {
+					const bool is_boolean = kind == expr_kind::logical_not;
+					const integer_t* const a = stack.back().data;
+					if (stack.back().is_boolean != is_boolean) {
+						type_error = true;
+						break;
+					}
+					if (kind == expr_kind::positive)
+						for (std::size_t i = 0; i < n; i++)
+							out[i] = a[i];
+					else if (kind == expr_kind::negative) {
+						result_state* const e = errors.data();
+						for (std::size_t i = 0; i < n; i++)
+							if (default_integer_policy::negate(a[i], out[i]) && e[i] == result_state::none)
+								e[i] = result_state::overflow_error;
+					}
+					else
+						for (std::size_t i = 0; i < n; i++)
+							out[i] = !a[i];
+					stack.back() = {out, is_boolean};
+					continue;
+				}
+				default:
+					break;
+			}
+			if (type_error)
+				break;
+
+			const operand right = stack.back();
+			stack.pop_back();
+			const operand left = stack.back();
+			const integer_t* const a = left.data;
+			const integer_t* const b = right.data;
+
+			switch (kind) {
+				case expr_kind::equal:
+				case expr_kind::not_equal:
+					type_error = left.is_boolean != right.is_boolean;
+					break;
+				case expr_kind::logical_and:
+				case expr_kind::logical_or:
+					type_error = !left.is_boolean || !right.is_boolean;
+					break;
+				default:
+					type_error = left.is_boolean || right.is_boolean;
+					break;
+			}
+			if (type_error)
+				break;
+
+			// a lane keeps its first error; the operations of an unchecked
+			// policy never overflow, so their loops have no branches
+			result_state* const e = errors.data();
+			bool is_boolean = true;
+			switch (kind) {
+				case expr_kind::addition:
+					for (std::size_t i = 0; i < n; i++)
+						if (default_integer_policy::add(a[i], b[i], out[i]) && e[i] == result_state::none)
+							e[i] = result_state::overflow_error;
+					is_boolean = false;
+					break;
+				case expr_kind::subtraction:
+					for (std::size_t i = 0; i < n; i++)
+						if (default_integer_policy::subtract(a[i], b[i], out[i]) && e[i] == result_state::none)
+							e[i] = result_state::overflow_error;
+					is_boolean = false;
+					break;
+				case expr_kind::multiplication:
+					for (std::size_t i = 0; i < n; i++)
+						if (default_integer_policy::multiply(a[i], b[i], out[i]) && e[i] == result_state::none)
+							e[i] = result_state::overflow_error;
+					is_boolean = false;
+					break;
+				case expr_kind::division:
+				case expr_kind::modulus:
+					// lanes that would trap get a harmless divisor
+					for (std::size_t i = 0; i < n; i++) {
+						const bool zero = b[i] == 0;
+						const bool trap = a[i] == default_integer_policy::min() && b[i] == -1;
+						const integer_t d = zero || trap ? 1 : b[i];
+						out[i] = kind == expr_kind::division ? a[i] / d : a[i] % d;
+						const result_state error = zero ? result_state::domain_error
+							: trap && default_integer_policy::checked && kind == expr_kind::division
+							? result_state::overflow_error : result_state::none;
+						if (error != result_state::none && e[i] == result_state::none)
+							e[i] = error;
+					}
+					is_boolean = false;
+					break;
+				case expr_kind::equal:
+					for (std::size_t i = 0; i < n; i++)
+						out[i] = a[i] == b[i];
+					break;
+				case expr_kind::not_equal:
+					for (std::size_t i = 0; i < n; i++)
+						out[i] = a[i] != b[i];
+					break;
+				case expr_kind::less:
+					for (std::size_t i = 0; i < n; i++)
+						out[i] = a[i] < b[i];
+					break;
+				case expr_kind::greater:
+					for (std::size_t i = 0; i < n; i++)
+						out[i] = a[i] > b[i];
+					break;
+				case expr_kind::less_equal:
+					for (std::size_t i = 0; i < n; i++)
+						out[i] = a[i] <= b[i];
+					break;
+				case expr_kind::greater_equal:
+					for (std::size_t i = 0; i < n; i++)
+						out[i] = a[i] >= b[i];
+					break;
+				case expr_kind::logical_and:
+					for (std::size_t i = 0; i < n; i++)
+						out[i] = a[i] & b[i];
+					break;
+				case expr_kind::logical_or:
+					for (std::size_t i = 0; i < n; i++)
+						out[i] = a[i] | b[i];
+					break;
+				default:
+					throw std::logic_error("calc::batch_evaluator::evaluate");
+			}
+			stack.back() = {out, is_boolean};
+		}
+
+		// the operands of a node are evaluated before its types are
+		// checked, so an error in a lane before the type error comes first;
+		// nodes after a type error are never reached in any lane
+		if (type_error) {
+			for (std::size_t i = 0; i < n; i++)
+				if (errors[i] == result_state::none)
+					errors[i] = result_state::invalid_argument;
+		}
+
+		const result_state type = !type_error && stack.back().is_boolean
+			? result_state::boolean : result_state::integer;
+		const integer_t* const values = type_error ? nullptr : stack.back().data;
+		for (std::size_t i = 0; i < n; i++) {
+			result& r = this->_results[g.members[i]];
+			r.state = errors[i] != result_state::none ? errors[i] : type;
+			r.data = values ? values[i] : 0;
+		}
+	}
+
+	std::unique_ptr<class value> batch_evaluator::value(std::size_t i) const {
+		const result& r = this->_results[i];
+
+		switch (r.state) {
+			case result_state::boolean:
+				return std::make_unique<boolean_value>(r.data != 0);
+			case result_state::integer:
+				return std::make_unique<integer_value>(r.data);
+			case result_state::domain_error:
+				throw std::domain_error("calc::batch_evaluator::value");
+			case result_state::invalid_argument:
+				throw std::invalid_argument("calc::batch_evaluator::value");
+			case result_state::overflow_error:
+				throw std::overflow_error("calc::batch_evaluator::value");
+			default:
+				throw std::out_of_range("calc::batch_evaluator::value");
+		}
+	}
+
+	void batch_evaluator::clear() noexcept {
+		if (this->_groups.size() > max_group_count) {
+			// expressions of few repeated shapes are what batches are for
+			this->_groups.clear();
+			this->_group_indexes.clear();
+		}
+		else {
+			for (std::size_t i : this->_active_groups) {
+				this->_groups[i].literals.clear();
+				this->_groups[i].members.clear();
+			}
+		}
+		this->_active_groups.clear();
+		this->_size = 0;
+	}
+} // namespace calc
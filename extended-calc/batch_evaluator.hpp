@@ -0,0 +1,143 @@
+/**
+ * @file		batch_evaluator.hpp
+ * Contains type declarations for evaluating many expressions at once.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_BATCH_EVALUATOR_HPP
+#define CALC_BATCH_EVALUATOR_HPP
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ast.hpp"
+
+namespace calc {
+	/**
+	 * Evaluates a batch of expressions column by column. Expressions are
+	 * grouped by shape, that is, by their kinds of node in postfix order,
+	 * so that the expressions of a group differ only in their literals.
+	 * The literals of a group become one column of integer_t lanes per
+	 * literal, and each operator node of the shape is evaluated by one
+	 * loop over every lane of the group, which the compiler can vectorize,
+	 * instead of by one virtual call per node per expression. Types depend
+	 * only on the shape, so they are checked once per group; division by
+	 * zero and the overflows of checked integers are flagged per lane.
+	 * Values and errors are the same as those of expr::value().
+	 */
+	class batch_evaluator {
+	public:
+		batch_evaluator();
+
+		batch_evaluator(const batch_evaluator&) = delete;
+
+		batch_evaluator& operator=(const batch_evaluator&) = delete;
+
+		/**
+		 * Adds an expression to the batch. The tree is not referenced
+		 * afterwards.
+		 * @param e		An expression.
+		 * @return		The index of @p e in the batch.
+		 * @throw std::invalid_argument	If @p e contains an error_expr.
+		 * @throw std::overflow_error	If @p e contains a big_integer.
+		 */
+		std::size_t add(const expr& e);
+
+		/**
+		 * Evaluates every expression added since the last call to clear().
+		 */
+		void evaluate();
+
+		/**
+		 * Returns the value of an expression after evaluate().
+		 * @param i		The index of the expression.
+		 * @return		The value of the expression.
+		 * @throw std::invalid_argument	If the operands of an operator have
+		 * 								the wrong types.
+		 * @throw std::domain_error		If the expression divides by zero.
+		 * @throw std::overflow_error	If a checked integer operation
+		 * 								overflows.
+		 */
+		std::unique_ptr<class value> value(std::size_t i) const;
+
+		/**
+		 * Removes every expression, but keeps the shapes seen so far and
+		 * the storage of their columns, up to a limit.
+		 */
+		void clear() noexcept;
+
+		std::size_t size() const noexcept {
+			return this->_size;
+		}
+
+		bool empty() const noexcept {
+			return this->_size == 0;
+		}
+
+	private:
+		class flattener;
+
+		/// The value or error of an expression, or of a lane.
+		enum class result_state : std::uint8_t {
+			none,
+			boolean,
+			integer,
+			invalid_argument,
+			domain_error,
+			overflow_error
+		};
+
+		struct result {
+			result_state state;
+			integer_t data;
+		};
+
+		/// The expressions of one shape.
+		struct group {
+			/// The expr_kind of each node, in postfix order.
+			std::string kinds;
+			/// The number of literals of the shape.
+			std::size_t literal_count;
+			/// The literals of each expression in turn, in postfix order,
+			/// which are split into columns when the group is evaluated.
+			std::vector<integer_t> literals;
+			/// The index in the batch of each lane.
+			std::vector<std::size_t> members;
+		};
+
+		/// A column on the evaluation stack.
+		struct operand {
+			const integer_t* data;
+			bool is_boolean;
+		};
+
+		/// The number of shapes beyond which clear() forgets them all.
+		static const std::size_t max_group_count = 65536;
+
+		std::vector<group> _groups;
+		std::unordered_map<std::string, std::size_t> _group_indexes;
+		/// The groups that have expressions in the batch.
+		std::vector<std::size_t> _active_groups;
+		std::size_t _size;
+		std::vector<result> _results;
+		// scratch storage, kept between calls
+		std::string _kinds;
+		std::vector<integer_t> _literals;
+		std::vector<std::vector<integer_t>> _scratch;
+		std::vector<result_state> _errors;
+		std::vector<operand> _stack;
+
+		void evaluate(group& g);
+	};
+} // namespace calc
+
+#endif // CALC_BATCH_EVALUATOR_HPP
@@ -0,0 +1,566 @@
+#include "config.hpp"
+
+#if HAVE_GETOPT_H
+#include <getopt.h>
+#endif
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "cli.hpp"
+#include "parser.hpp"
+#include "perf_counters.hpp"
+
+// ---------------------------------------------------------------------------
+// Allocation counting
+// ---------------------------------------------------------------------------
+
+static std::size_t allocation_count = 0;
+
+void* operator new(std::size_t size) {
+	allocation_count++;
+	if (void* p = std::malloc(size ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+	return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+// ---------------------------------------------------------------------------
+// Workloads
+// ---------------------------------------------------------------------------
+
+/**
+ * Generates a deterministic script for a single benchmark workload.
+ */
+class workload {
+public:
+	workload(const char* name, std::size_t lines) :
+		_name(name), _lines(lines), _engine(42)
+	{}
+
+	virtual ~workload() {}
+
+	const char* name() const {
+		return this->_name;
+	}
+
+	std::string script() {
+		std::string result;
+		for (std::size_t i = 0; i < this->_lines; i++) {
+			this->line(result);
+			result += '\n';
+		}
+		return result;
+	}
+
+protected:
+	std::size_t lines() const {
+		return this->_lines;
+	}
+
+	unsigned int random(unsigned int n) {
+		return std::uniform_int_distribution<unsigned int>(0, n - 1)(this->_engine);
+	}
+
+	std::string integer(unsigned int max_digits) {
+		std::string result(1, static_cast<char>('1' + this->random(9)));
+		const unsigned int digits = this->random(max_digits);
+		for (unsigned int i = 0; i < digits; i++)
+			result += static_cast<char>('0' + this->random(10));
+		return result;
+	}
+
+	virtual void line(std::string& out) = 0;
+
+private:
+	const char* _name;
+	std::size_t _lines;
+	std::mt19937 _engine;
+};
+
+/// Long integer literals joined by additive operators.
+class literal_heavy_workload : public workload {
+public:
+	explicit literal_heavy_workload(std::size_t lines) :
+		workload("literal_heavy", lines)
+	{}
+
+protected:
+	void line(std::string& out) {
+		for (int i = 0; i < 8; i++) {
+			if (i > 0)
+				out += this->random(2) ? " + " : " - ";
+			out += this->integer(4);
+		}
+	}
+};
+
+/// Short literals with many unary, binary and logical operators.
+class operator_heavy_workload : public workload {
+public:
+	explicit operator_heavy_workload(std::size_t lines) :
+		workload("operator_heavy", lines)
+	{}
+
+protected:
+	void line(std::string& out) {
+		static const char* const integer_operators[] = {" + ", " - ", " * ", " / ", " % "};
+		static const char* const ordering_operators[] = {" < ", " > ", " == ", " != "};
+
+		for (int i = 0; i < 3; i++) {
+			if (i > 0)
+				out += this->random(2) ? " && " : " || ";
+			if (this->random(2))
+				out += '!';
+			out += '(';
+			for (int j = 0; j < 4; j++) {
+				if (j > 0)
+					out += integer_operators[this->random(5)];
+				out += this->random(2) ? "-" : "+";
+				out += this->integer(1);
+			}
+			out += ordering_operators[this->random(4)];
+			out += this->integer(1);
+			out += ')';
+		}
+	}
+};
+
+/// Deeply nested parentheses.
+class deeply_nested_workload : public workload {
+public:
+	explicit deeply_nested_workload(std::size_t lines) :
+		workload("deeply_nested", lines)
+	{}
+
+protected:
+	void line(std::string& out) {
+		const int depth = 64;
+		out.append(depth, '(');
+		out += this->integer(2);
+		for (int i = 0; i < depth; i++) {
+			out += this->random(2) ? " + " : " * ";
+			out += this->integer(2);
+			out += ')';
+		}
+	}
+};
+
+/// A few very long lines.
+class long_line_workload : public workload {
+public:
+	explicit long_line_workload(std::size_t lines) :
+		workload("long_line", std::max<std::size_t>(lines / 256, 1))
+	{}
+
+protected:
+	void line(std::string& out) {
+		out += this->integer(3);
+		for (int i = 0; i < 2048; i++) {
+			out += this->random(2) ? " + " : " - ";
+			out += this->integer(3);
+		}
+	}
+};
+
+/// Half of the lines contain a syntax error.
+class error_heavy_workload : public workload {
+public:
+	explicit error_heavy_workload(std::size_t lines) :
+		workload("error_heavy", lines)
+	{}
+
+protected:
+	void line(std::string& out) {
+		out += this->integer(2) + " + " + this->integer(2);
+		switch (this->random(6)) {
+			case 0:
+				out += " $ 1";
+				break;
+			case 1:
+				out += " +";
+				break;
+			case 2:
+				out = out + " * (" + this->integer(2);
+				break;
+			default:
+				out += " * " + this->integer(2);
+				break;
+		}
+	}
+};
+
+// ---------------------------------------------------------------------------
+// Measurements
+// ---------------------------------------------------------------------------
+
+typedef std::chrono::steady_clock clock_type;
+
+static double seconds_since(clock_type::time_point start) {
+	return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+/**
+ * Counts the nodes in an abstract syntax tree.
+ */
+class node_counter : public calc::expr_visitor {
+public:
+	std::size_t count = 0;
+
+	void visit(const calc::positive_expr& e) { this->unary(e); }
+	void visit(const calc::negative_expr& e) { this->unary(e); }
+	void visit(const calc::addition_expr& e) { this->binary(e); }
+	void visit(const calc::subtraction_expr& e) { this->binary(e); }
+	void visit(const calc::multiplication_expr& e) { this->binary(e); }
+	void visit(const calc::division_expr& e) { this->binary(e); }
+	void visit(const calc::modulus_expr& e) { this->binary(e); }
+	void visit(const calc::equal_expr& e) { this->binary(e); }
+	void visit(const calc::not_equal_expr& e) { this->binary(e); }
+	void visit(const calc::less_expr& e) { this->binary(e); }
+	void visit(const calc::greater_expr& e) { this->binary(e); }
+	void visit(const calc::less_equal_expr& e) { this->binary(e); }
+	void visit(const calc::greater_equal_expr& e) { this->binary(e); }
+	void visit(const calc::logical_not_expr& e) { this->unary(e); }
+	void visit(const calc::logical_and_expr& e) { this->binary(e); }
+	void visit(const calc::logical_or_expr& e) { this->binary(e); }
+	void visit(const calc::boolean& e) { this->count++; }
+	void visit(const calc::integer& e) { this->count++; }
+	void visit(const calc::big_integer& e) { this->count++; }
+
+	void visit(const calc::error_expr& e) {
+		this->count++;
+		for (const auto& operand : e.operands())
+			operand->accept(*this);
+	}
+
+private:
+	void unary(const calc::unary_expr& e) {
+		this->count++;
+		e.operand()->accept(*this);
+	}
+
+	void binary(const calc::binary_expr& e) {
+		this->count++;
+		e.left_operand()->accept(*this);
+		e.right_operand()->accept(*this);
+	}
+};
+
+struct lexer_result {
+	std::size_t tokens;
+	double seconds;
+	calc::perf_sample counters;
+};
+
+struct parser_result {
+	std::size_t expressions;
+	std::size_t nodes;
+	std::size_t errors;
+	std::size_t allocations;
+	double seconds;
+	calc::perf_sample counters;
+};
+
+struct evaluator_result {
+	std::size_t expressions;
+	std::size_t errors;
+	std::size_t allocations;
+	double seconds;
+	calc::perf_sample counters;
+};
+
+/// Keeps the fastest of several repetitions, along with its counters.
+template <typename Result>
+static void keep_fastest(Result& best, const Result& candidate) {
+	if (candidate.seconds < best.seconds) {
+		best.seconds = candidate.seconds;
+		best.counters = candidate.counters;
+	}
+}
+
+template <typename CharT>
+static lexer_result measure_lexer(const std::basic_string<CharT>& script,
+                                  calc::perf_counters& counters)
+{
+	std::basic_stringbuf<CharT> buffer(script);
+	calc::basic_lexer<CharT> lexer(&buffer);
+	lexer_result result = {0, 0, {}};
+
+	counters.start();
+	const clock_type::time_point start = clock_type::now();
+	while (lexer.next_token().kind() != calc::token_kind::eof)
+		result.tokens++;
+	result.seconds = seconds_since(start);
+	result.counters = counters.stop();
+
+	return result;
+}
+
+template <typename CharT>
+static parser_result
+measure_parser(const std::basic_string<CharT>& script,
+               calc::perf_counters& counters,
+               std::vector<std::unique_ptr<const calc::expr>>* exprs = nullptr)
+{
+	std::basic_stringbuf<CharT> buffer(script);
+	calc::basic_parser<CharT> parser(&buffer);
+	parser_result result = {0, 0, 0, 0, 0, {}};
+
+	const std::size_t start_allocations = allocation_count;
+	counters.start();
+	const clock_type::time_point start = clock_type::now();
+	while (true) {
+		try {
+			std::unique_ptr<const calc::expr> expr = parser.next_expr();
+			if (!expr)
+				break;
+			result.expressions++;
+			if (exprs)
+				exprs->push_back(std::move(expr));
+		}
+		catch (const calc::basic_parse_error<CharT>& exception) {
+			result.errors++;
+		}
+	}
+	result.seconds = seconds_since(start);
+	result.counters = counters.stop();
+	result.allocations = allocation_count - start_allocations;
+
+	if (exprs)
+		for (const auto& i : *exprs) {
+			node_counter counter;
+			i->accept(counter);
+			result.nodes += counter.count;
+		}
+
+	return result;
+}
+
+static evaluator_result
+measure_evaluator(const std::vector<std::unique_ptr<const calc::expr>>& exprs,
+                  calc::perf_counters& counters)
+{
+	evaluator_result result = {0, 0, 0, 0, {}};
+
+	const std::size_t start_allocations = allocation_count;
+	counters.start();
+	const clock_type::time_point start = clock_type::now();
+	for (const auto& i : exprs) {
+		try {
+			std::unique_ptr<calc::value> value = i->value();
+			result.expressions++;
+		}
+		catch (const std::logic_error& exception) {
+			result.errors++;
+		}
+	}
+	result.seconds = seconds_since(start);
+	result.counters = counters.stop();
+	result.allocations = allocation_count - start_allocations;
+
+	return result;
+}
+
+static std::basic_string<char> convert(const std::string& str, char) {
+	return str;
+}
+
+static std::basic_string<wchar_t> convert(const std::string& str, wchar_t) {
+	return std::wstring(str.cbegin(), str.cend());
+}
+
+/**
+ * Writes the hardware counters of a phase, followed by the instructions per
+ * cycle and the misses per thousand instructions, as a JSON member.
+ */
+static void write_counters(std::ostream& out, const calc::perf_sample& sample) {
+	const calc::perf_event rates[] = {
+		calc::perf_event::branch_misses,
+		calc::perf_event::l1d_read_misses,
+		calc::perf_event::llc_read_misses,
+		calc::perf_event::dtlb_read_misses
+	};
+	const bool has_instructions = sample.has(calc::perf_event::instructions)
+	                              && sample[calc::perf_event::instructions] > 0;
+
+	out << "        \"counters\": {";
+	bool first = true;
+	for (std::size_t i = 0; i < calc::perf_event_count; i++) {
+		const calc::perf_event e = static_cast<calc::perf_event>(i);
+		if (!sample.has(e))
+			continue;
+		out << (first ? "" : ",") << "\n          \"" << calc::perf_event_name(e)
+		    << "\": " << sample[e];
+		first = false;
+	}
+	if (has_instructions && sample.has(calc::perf_event::cycles)
+	    && sample[calc::perf_event::cycles] > 0)
+		out << ",\n          \"ipc\": "
+		    << double(sample[calc::perf_event::instructions]) / sample[calc::perf_event::cycles];
+	if (has_instructions)
+		for (calc::perf_event e : rates)
+			if (sample.has(e))
+				out << ",\n          \"" << calc::perf_event_name(e) << "_per_kilo_instruction\": "
+				    << 1000.0 * sample[e] / sample[calc::perf_event::instructions];
+	out << (first ? "}" : "\n        }");
+}
+
+template <typename CharT>
+static void run(std::ostream& out, workload& w, const std::string& script,
+                const char* char_type, unsigned int repetitions,
+                calc::perf_counters& counters)
+{
+	const std::basic_string<CharT> converted = convert(script, CharT());
+
+	lexer_result lex = measure_lexer(converted, counters);
+	for (unsigned int i = 1; i < repetitions; i++)
+		keep_fastest(lex, measure_lexer(converted, counters));
+
+	std::vector<std::unique_ptr<const calc::expr>> exprs;
+	parser_result parse = measure_parser(converted, counters, &exprs);
+	for (unsigned int i = 1; i < repetitions; i++)
+		keep_fastest(parse, measure_parser(converted, counters));
+
+	evaluator_result eval = measure_evaluator(exprs, counters);
+	for (unsigned int i = 1; i < repetitions; i++)
+		keep_fastest(eval, measure_evaluator(exprs, counters));
+
+	const std::size_t attempts = parse.expressions + parse.errors;
+
+	out << "    {\n"
+	    << "      \"workload\": \"" << w.name() << "\",\n"
+	    << "      \"char_type\": \"" << char_type << "\",\n"
+	    << "      \"bytes\": " << script.size() << ",\n"
+	    << "      \"lexer\": {\n"
+	    << "        \"tokens\": " << lex.tokens << ",\n"
+	    << "        \"seconds\": " << lex.seconds << ",\n"
+	    << "        \"tokens_per_second\": " << lex.tokens / lex.seconds << ",\n";
+	write_counters(out, lex.counters);
+	out << "\n"
+	    << "      },\n"
+	    << "      \"parser\": {\n"
+	    << "        \"expressions\": " << parse.expressions << ",\n"
+	    << "        \"errors\": " << parse.errors << ",\n"
+	    << "        \"nodes\": " << parse.nodes << ",\n"
+	    << "        \"seconds\": " << parse.seconds << ",\n"
+	    << "        \"expressions_per_second\": " << attempts / parse.seconds << ",\n"
+	    << "        \"ns_per_node\": " << (parse.nodes ? parse.seconds * 1e9 / parse.nodes : 0.0) << ",\n"
+	    << "        \"allocations_per_expression\": " << (attempts ? double(parse.allocations) / attempts : 0.0) << ",\n";
+	write_counters(out, parse.counters);
+	out << "\n"
+	    << "      },\n"
+	    << "      \"evaluator\": {\n"
+	    << "        \"expressions\": " << eval.expressions << ",\n"
+	    << "        \"errors\": " << eval.errors << ",\n"
+	    << "        \"seconds\": " << eval.seconds << ",\n"
+	    << "        \"expressions_per_second\": " << exprs.size() / eval.seconds << ",\n"
+	    << "        \"ns_per_node\": " << (parse.nodes ? eval.seconds * 1e9 / parse.nodes : 0.0) << ",\n"
+	    << "        \"allocations_per_expression\": " << (exprs.empty() ? 0.0 : double(eval.allocations) / exprs.size()) << ",\n";
+	write_counters(out, eval.counters);
+	out << "\n"
+	    << "      }\n"
+	    << "    }";
+}
+
+static void usage(std::ostream& out) {
+	out << "Usage: calc_bench [--lines N] [--repetitions N]\n"
+	    << "Measures lexer, parser and evaluator throughput and prints the\n"
+	    << "results as JSON.\n";
+}
+
+int main(int argc, char* argv[]) {
+	calc::init(argv[0]);
+
+	std::size_t lines = 5000;
+	unsigned int repetitions = 3;
+
+#if HAVE_GETOPT_H
+	static const struct option long_options[] = {
+		{"lines", required_argument, nullptr, 'n'},
+		{"repetitions", required_argument, nullptr, 'r'},
+		{"help", no_argument, nullptr, 'h'},
+		{nullptr, 0, nullptr, 0}
+	};
+	int c;
+
+	while ((c = getopt_long(argc, argv, "n:r:h", long_options, nullptr)) != -1) {
+		switch (c) {
+			case 'n':
+				lines = std::strtoul(optarg, nullptr, 10);
+				break;
+			case 'r':
+				repetitions = std::max(1ul, std::strtoul(optarg, nullptr, 10));
+				break;
+			case 'h':
+				usage(std::cout);
+				return 0;
+			default:
+				usage(std::cerr);
+				return 2;
+		}
+	}
+#endif
+
+	literal_heavy_workload literal_heavy(lines);
+	operator_heavy_workload operator_heavy(lines);
+	deeply_nested_workload deeply_nested(lines / 4);
+	long_line_workload long_line(lines);
+	error_heavy_workload error_heavy(lines);
+	workload* const workloads[] = {
+		&literal_heavy, &operator_heavy, &deeply_nested, &long_line,
+		&error_heavy
+	};
+
+	calc::perf_counters counters;
+	std::ostringstream out;
+	bool first = true;
+
+	// without counters, the timings are still worth reporting
+	if (!counters.available())
+		calc::report_error("hardware counters unavailable (%s)", counters.error().c_str());
+
+	out << "{\n"
+	    << "  \"counters_available\": " << (counters.available() ? "true" : "false") << ",\n"
+	    << "  \"benchmarks\": [\n";
+	for (workload* w : workloads) {
+		const std::string script = w->script();
+		if (!first)
+			out << ",\n";
+		run<char>(out, *w, script, "char", repetitions, counters);
+		out << ",\n";
+		run<wchar_t>(out, *w, script, "wchar_t", repetitions, counters);
+		first = false;
+	}
+	out << "\n"
+	    << "  ]\n"
+	    << "}\n";
+
+	std::cout << out.str();
+
+	return 0;
+}
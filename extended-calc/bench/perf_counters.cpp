@@ -0,0 +1,163 @@
+/**
+ * @file		perf_counters.cpp
+ * Contains type definitions for reading hardware performance counters.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#include "perf_counters.hpp"
+
+#if HAVE_LINUX_PERF_EVENT_H
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include <cerrno>
+#include <cstring>
+
+namespace calc {
+#if HAVE_LINUX_PERF_EVENT_H
+	namespace {
+		struct event_config {
+			std::uint32_t type;
+			std::uint64_t config;
+		};
+
+		std::uint64_t cache_event(std::uint64_t cache) {
+			return cache
+			       | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+			       | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		}
+
+		const event_config event_configs[perf_event_count] = {
+			{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+			{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+			{PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+			{PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D)},
+			{PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_LL)},
+			{PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_DTLB)}
+		};
+
+		/// The layout of a counter read with PERF_FORMAT_TOTAL_TIME_ENABLED
+		/// and PERF_FORMAT_TOTAL_TIME_RUNNING.
+		struct read_format {
+			std::uint64_t value;
+			std::uint64_t time_enabled;
+			std::uint64_t time_running;
+		};
+
+		int open_event(const event_config& e) {
+			struct perf_event_attr attr;
+			std::memset(&attr, 0, sizeof attr);
+			attr.size = sizeof attr;
+			attr.type = e.type;
+			attr.config = e.config;
+			attr.disabled = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED
+			                   | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			// this thread, on any CPU, in no group
+			return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+		}
+	} // namespace
+#endif
+
+	const char* perf_event_name(perf_event e) noexcept {
+		switch (e) {
+			case perf_event::cycles:
+				return "cycles";
+			case perf_event::instructions:
+				return "instructions";
+			case perf_event::branch_misses:
+				return "branch_misses";
+			case perf_event::l1d_read_misses:
+				return "l1d_read_misses";
+			case perf_event::llc_read_misses:
+				return "llc_read_misses";
+			case perf_event::dtlb_read_misses:
+				return "dtlb_read_misses";
+		}
+		return "unknown";
+	}
+
+	perf_counters::perf_counters() : _error() {
+		for (int& fd : this->_fds)
+			fd = -1;
+
+#if HAVE_LINUX_PERF_EVENT_H
+		int first_error = 0;
+
+		for (std::size_t i = 0; i < perf_event_count; i++) {
+			this->_fds[i] = open_event(event_configs[i]);
+			if (this->_fds[i] < 0 && first_error == 0)
+				first_error = errno;
+		}
+
+		if (!this->available())
+			this->_error = std::string("perf_event_open: ") + std::strerror(first_error);
+#else
+		this->_error = "hardware counters are not supported on this platform";
+#endif
+	}
+
+	perf_counters::~perf_counters() {
+#if HAVE_LINUX_PERF_EVENT_H
+		for (int fd : this->_fds)
+			if (fd >= 0)
+				close(fd);
+#endif
+	}
+
+	bool perf_counters::available() const noexcept {
+		for (int fd : this->_fds)
+			if (fd >= 0)
+				return true;
+		return false;
+	}
+
+	void perf_counters::start() noexcept {
+#if HAVE_LINUX_PERF_EVENT_H
+		for (int fd : this->_fds)
+			if (fd >= 0) {
+				ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+				ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+			}
+#endif
+	}
+
+	perf_sample perf_counters::stop() noexcept {
+		perf_sample sample;
+
+		for (std::size_t i = 0; i < perf_event_count; i++) {
+			sample.valid[i] = false;
+			sample.counts[i] = 0;
+		}
+
+#if HAVE_LINUX_PERF_EVENT_H
+		for (int fd : this->_fds)
+			if (fd >= 0)
+				ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+		for (std::size_t i = 0; i < perf_event_count; i++) {
+			read_format r;
+			if (this->_fds[i] < 0
+			    || read(this->_fds[i], &r, sizeof r) != static_cast<ssize_t>(sizeof r)
+			    || r.time_running == 0)
+				continue;
+
+			sample.valid[i] = true;
+			// extrapolate if the counter only ran for part of the interval
+			sample.counts[i] = r.time_running < r.time_enabled
+				? static_cast<std::uint64_t>(static_cast<double>(r.value)
+				                             * r.time_enabled / r.time_running)
+				: r.value;
+		}
+#endif
+
+		return sample;
+	}
+} // namespace calc
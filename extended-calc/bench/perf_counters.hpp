@@ -0,0 +1,93 @@
+/**
+ * @file		perf_counters.hpp
+ * Contains type declarations for reading hardware performance counters.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_BENCH_PERF_COUNTERS_HPP
+#define CALC_BENCH_PERF_COUNTERS_HPP
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace calc {
+	/// The hardware events that perf_counters can count.
+	enum class perf_event {
+		cycles,
+		instructions,
+		branch_misses,
+		l1d_read_misses,
+		llc_read_misses,
+		dtlb_read_misses
+	};
+
+	/// The number of enumerators in perf_event.
+	const std::size_t perf_event_count = 6;
+
+	const char* perf_event_name(perf_event e) noexcept;
+
+	/**
+	 * The counts of a measured interval. Counts are scaled up if the kernel
+	 * had to multiplex the counters.
+	 */
+	struct perf_sample {
+		bool valid[perf_event_count];
+		std::uint64_t counts[perf_event_count];
+
+		bool has(perf_event e) const noexcept {
+			return this->valid[static_cast<std::size_t>(e)];
+		}
+
+		std::uint64_t operator[](perf_event e) const noexcept {
+			return this->counts[static_cast<std::size_t>(e)];
+		}
+	};
+
+	/**
+	 * Counts hardware events of the calling thread in user space, using
+	 * perf_event_open(2) directly. Each event is opened on its own, so a
+	 * platform that lacks some events still reports the others. If no event
+	 * can be opened, for example in a container or when perf_event_paranoid
+	 * forbids it, available() is false and every sample is empty.
+	 */
+	class perf_counters {
+	public:
+		perf_counters();
+		perf_counters(const perf_counters&) = delete;
+		~perf_counters();
+
+		perf_counters& operator=(const perf_counters&) = delete;
+
+		bool available() const noexcept;
+
+		/**
+		 * Returns the reason why no counter could be opened.
+		 * @return	A description of the error, or an empty string if at
+		 * 			least one counter is available.
+		 */
+		const std::string& error() const noexcept {
+			return this->_error;
+		}
+
+		/// Resets and starts every counter.
+		void start() noexcept;
+
+		/**
+		 * Stops every counter and reads it.
+		 * @return	The counts since the last call to start().
+		 */
+		perf_sample stop() noexcept;
+
+	private:
+		int _fds[perf_event_count];
+		std::string _error;
+	};
+} // namespace calc
+
+#endif // CALC_BENCH_PERF_COUNTERS_HPP
@@ -0,0 +1,460 @@
+/**
+ * @file		bigint.cpp
+ * Contains type definitions for arbitrary-precision integers.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#include "bigint.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace calc {
+	namespace {
+		typedef bigint::limb_type limb_type;
+		typedef integer_policy<64> small_policy;
+
+		const unsigned int limb_bits = 32;
+
+		/// The operand size in limbs from which multiplication uses the
+		/// Karatsuba algorithm instead of the schoolbook algorithm.
+		const std::size_t karatsuba_threshold = 32;
+
+		/// The largest power of ten that fits in a limb.
+		const limb_type decimal_base = 1000000000;
+		const unsigned int decimal_base_digits = 9;
+
+		/// Adds @p b to @p a, which has at least as many limbs, and returns
+		/// the carry out of @p a.
+		limb_type add_into(limb_type* a, std::size_t a_size, const limb_type* b,
+		                   std::size_t b_size) noexcept
+		{
+			std::uint64_t carry = 0;
+			std::size_t i = 0;
+			for (; i < b_size; i++) {
+				carry += static_cast<std::uint64_t>(a[i]) + b[i];
+				a[i] = static_cast<limb_type>(carry);
+				carry >>= limb_bits;
+			}
+			for (; carry != 0 && i < a_size; i++) {
+				carry += a[i];
+				a[i] = static_cast<limb_type>(carry);
+				carry >>= limb_bits;
+			}
+			return static_cast<limb_type>(carry);
+		}
+
+		/// Subtracts @p b from @p a, which is not less than @p b.
+		void subtract_from(limb_type* a, std::size_t a_size, const limb_type* b,
+		                   std::size_t b_size) noexcept
+		{
+			limb_type borrow = 0;
+			std::size_t i = 0;
+			for (; i < b_size; i++) {
+				const std::uint64_t difference = static_cast<std::uint64_t>(a[i]) - b[i] - borrow;
+				a[i] = static_cast<limb_type>(difference);
+				borrow = static_cast<limb_type>(difference >> limb_bits) & 1;
+			}
+			for (; borrow != 0 && i < a_size; i++) {
+				borrow = a[i] == 0;
+				a[i]--;
+			}
+			assert(borrow == 0);
+		}
+
+		/// Stores the @p a_size + @p b_size limbs of @p a times @p b.
+		void multiply_schoolbook(const limb_type* a, std::size_t a_size,
+		                         const limb_type* b, std::size_t b_size,
+		                         limb_type* result) noexcept
+		{
+			std::fill(result, result + a_size + b_size, 0);
+			for (std::size_t i = 0; i < a_size; i++) {
+				std::uint64_t carry = 0;
+				for (std::size_t j = 0; j < b_size; j++) {
+					carry += static_cast<std::uint64_t>(a[i]) * b[j] + result[i + j];
+					result[i + j] = static_cast<limb_type>(carry);
+					carry >>= limb_bits;
+				}
+				result[i + b_size] = static_cast<limb_type>(carry);
+			}
+		}
+
+		/**
+		 * Stores the 2 @p size limbs of @p a times @p b, both of @p size
+		 * limbs. With a = a1 B + a0 and b = b1 B + b0, the product is
+		 * z2 B^2 + z1 B + z0, where z2 = a1 b1, z0 = a0 b0, and
+		 * z1 = (a1 + a0)(b1 + b0) - z2 - z0 takes one multiplication
+		 * instead of two.
+		 */
+		void multiply_karatsuba(const limb_type* a, const limb_type* b,
+		                        std::size_t size, limb_type* result)
+		{
+			if (size < karatsuba_threshold) {
+				multiply_schoolbook(a, size, b, size, result);
+				return;
+			}
+
+			const std::size_t low = size / 2;
+			const std::size_t high = size - low;
+			// z0 and z2 go straight to their places in the result
+			multiply_karatsuba(a, b, low, result);
+			multiply_karatsuba(a + low, b + low, high, result + 2 * low);
+
+			std::vector<limb_type> a_sum(a + low, a + size);
+			std::vector<limb_type> b_sum(b + low, b + size);
+			a_sum.push_back(add_into(a_sum.data(), high, a, low));
+			b_sum.push_back(add_into(b_sum.data(), high, b, low));
+			std::vector<limb_type> middle(2 * (high + 1));
+			multiply_karatsuba(a_sum.data(), b_sum.data(), high + 1, middle.data());
+			subtract_from(middle.data(), middle.size(), result, 2 * low);
+			subtract_from(middle.data(), middle.size(), result + 2 * low, 2 * high);
+
+			// the top limbs of the middle term are zero beyond the product
+			std::size_t middle_size = middle.size();
+			while (middle_size > 0 && middle[middle_size - 1] == 0)
+				middle_size--;
+			assert(middle_size <= 2 * size - low);
+			add_into(result + low, 2 * size - low, middle.data(), middle_size);
+		}
+
+		/// Stores the @p a_size + @p b_size limbs of @p a times @p b.
+		void multiply_range(const limb_type* a, std::size_t a_size,
+		                    const limb_type* b, std::size_t b_size,
+		                    limb_type* result)
+		{
+			if (a_size < b_size) {
+				std::swap(a, b);
+				std::swap(a_size, b_size);
+			}
+			if (b_size < karatsuba_threshold) {
+				multiply_schoolbook(a, a_size, b, b_size, result);
+				return;
+			}
+
+			// the longer operand is multiplied in pieces as long as the
+			// shorter one
+			std::fill(result, result + a_size + b_size, 0);
+			std::vector<limb_type> product(2 * b_size);
+			for (std::size_t i = 0; i < a_size; i += b_size) {
+				const std::size_t size = std::min(b_size, a_size - i);
+				if (size == b_size)
+					multiply_karatsuba(a + i, b, b_size, product.data());
+				else
+					multiply_range(a + i, size, b, b_size, product.data());
+				add_into(result + i, a_size + b_size - i, product.data(), size + b_size);
+			}
+		}
+
+		unsigned int leading_zeros(limb_type v) noexcept {
+			unsigned int count = 0;
+			for (limb_type bit = limb_type(1) << (limb_bits - 1); bit != 0 && !(v & bit); bit >>= 1)
+				count++;
+			return count;
+		}
+	} // namespace
+
+#if HAVE_INT128
+	bigint::bigint(__int128 v) : bigint() {
+		if (v >= INT64_MIN && v <= INT64_MAX) {
+			this->_small = static_cast<std::int64_t>(v);
+			return;
+		}
+		unsigned __int128 u = v < 0 ? 0 - static_cast<unsigned __int128>(v)
+		                            : static_cast<unsigned __int128>(v);
+		magnitude_type m;
+		for (; u != 0; u >>= limb_bits)
+			m.push_back(static_cast<limb_type>(u));
+		*this = bigint(v < 0, std::move(m));
+	}
+#endif
+
+	bigint::bigint(bool negative, magnitude_type&& magnitude) : bigint() {
+		while (!magnitude.empty() && magnitude.back() == 0)
+			magnitude.pop_back();
+		if (magnitude.size() <= 2) {
+			const std::uint64_t u = magnitude.empty() ? 0 : magnitude.size() == 1
+				? magnitude[0]
+				: static_cast<std::uint64_t>(magnitude[1]) << limb_bits | magnitude[0];
+			const std::uint64_t limit = static_cast<std::uint64_t>(INT64_MAX) + (negative ? 1 : 0);
+			if (u <= limit) {
+				this->_small = negative ? static_cast<std::int64_t>(0 - u) : static_cast<std::int64_t>(u);
+				return;
+			}
+		}
+		this->_negative = negative;
+		this->_limbs = std::move(magnitude);
+	}
+
+	std::string bigint::to_string() const {
+		if (this->_limbs.empty())
+			return small_policy::to_string(this->_small);
+
+		// the digits come out nine at a time, least significant first
+		magnitude_type m = this->_limbs;
+		std::vector<limb_type> chunks;
+		while (!m.empty()) {
+			chunks.push_back(divide(m, decimal_base));
+			while (!m.empty() && m.back() == 0)
+				m.pop_back();
+		}
+
+		std::string result;
+		if (this->_negative)
+			result.push_back('-');
+		result += std::to_string(chunks.back());
+		for (std::size_t i = chunks.size() - 1; i-- > 0; ) {
+			const std::string digits = std::to_string(chunks[i]);
+			result.append(decimal_base_digits - digits.size(), '0');
+			result += digits;
+		}
+		return result;
+	}
+
+	int bigint::compare(const bigint& a, const bigint& b) noexcept {
+		if (a._limbs.empty() && b._limbs.empty())
+			return a._small < b._small ? -1 : a._small > b._small ? 1 : 0;
+
+		const bool a_negative = a.is_negative();
+		if (a_negative != b.is_negative())
+			return a_negative ? -1 : 1;
+		// a small value has a smaller magnitude than a large one
+		const int c = a._limbs.empty() ? -1 : b._limbs.empty() ? 1
+			: compare(a._limbs, b._limbs);
+		return a_negative ? -c : c;
+	}
+
+	bigint bigint::operator-() const {
+		if (this->_limbs.empty() && this->_small != INT64_MIN)
+			return bigint(static_cast<long long>(-this->_small));
+		return bigint(!this->is_negative(), magnitude(*this));
+	}
+
+	bigint& bigint::operator+=(const bigint& other) {
+		return *this = sum(*this, other, false);
+	}
+
+	bigint& bigint::operator-=(const bigint& other) {
+		return *this = sum(*this, other, true);
+	}
+
+	bigint& bigint::operator*=(const bigint& other) {
+		std::int64_t result;
+		if (this->_limbs.empty() && other._limbs.empty()
+		    && !small_policy::multiply(this->_small, other._small, result))
+			this->_small = result;
+		else
+			*this = bigint(this->is_negative() != other.is_negative(),
+			               multiply(magnitude(*this), magnitude(other)));
+		return *this;
+	}
+
+	bigint& bigint::operator/=(const bigint& other) {
+		bigint quotient, remainder;
+		divide(*this, other, quotient, remainder);
+		return *this = std::move(quotient);
+	}
+
+	bigint& bigint::operator%=(const bigint& other) {
+		bigint quotient, remainder;
+		divide(*this, other, quotient, remainder);
+		return *this = std::move(remainder);
+	}
+
+	void bigint::divide(const bigint& a, const bigint& b, bigint& quotient,
+	                    bigint& remainder)
+	{
+		if (b.is_zero())
+			throw std::domain_error("calc::bigint::divide");
+
+		if (a._limbs.empty() && b._limbs.empty()
+		    && !(a._small == INT64_MIN && b._small == -1)) {
+			const std::int64_t q = a._small / b._small;
+			const std::int64_t r = a._small % b._small;
+			quotient = bigint(static_cast<long long>(q));
+			remainder = bigint(static_cast<long long>(r));
+			return;
+		}
+
+		const bool a_negative = a.is_negative();
+		const bool b_negative = b.is_negative();
+		magnitude_type q = magnitude(a);
+		const magnitude_type divisor = magnitude(b);
+		magnitude_type r;
+
+		if (compare(q, divisor) < 0) {
+			r.swap(q);
+		}
+		else if (divisor.size() == 1) {
+			// short division by one limb
+			r = magnitude(divide(q, divisor[0]));
+		}
+		else {
+			const magnitude_type dividend = std::move(q);
+			divide(dividend, divisor, q, r);
+		}
+		quotient = bigint(a_negative != b_negative, std::move(q));
+		remainder = bigint(a_negative, std::move(r));
+	}
+
+	bigint::magnitude_type bigint::magnitude(const bigint& v) {
+		if (!v._limbs.empty())
+			return v._limbs;
+		return magnitude(v._small < 0 ? 0 - static_cast<std::uint64_t>(v._small)
+		                              : static_cast<std::uint64_t>(v._small));
+	}
+
+	bigint::magnitude_type bigint::magnitude(std::uint64_t v) {
+		magnitude_type result;
+		for (; v != 0; v >>= limb_bits)
+			result.push_back(static_cast<limb_type>(v));
+		return result;
+	}
+
+	void bigint::add(magnitude_type& a, const magnitude_type& b) {
+		if (a.size() < b.size())
+			a.resize(b.size());
+		const limb_type carry = add_into(a.data(), a.size(), b.data(), b.size());
+		if (carry != 0)
+			a.push_back(carry);
+	}
+
+	void bigint::subtract(magnitude_type& a, const magnitude_type& b) noexcept {
+		subtract_from(a.data(), a.size(), b.data(), b.size());
+	}
+
+	int bigint::compare(const magnitude_type& a, const magnitude_type& b) noexcept {
+		if (a.size() != b.size())
+			return a.size() < b.size() ? -1 : 1;
+		for (std::size_t i = a.size(); i-- > 0; )
+			if (a[i] != b[i])
+				return a[i] < b[i] ? -1 : 1;
+		return 0;
+	}
+
+	bigint::magnitude_type bigint::multiply(const magnitude_type& a, const magnitude_type& b) {
+		if (a.empty() || b.empty())
+			return magnitude_type();
+		magnitude_type result(a.size() + b.size());
+		multiply_range(a.data(), a.size(), b.data(), b.size(), result.data());
+		return result;
+	}
+
+	/**
+	 * Divides magnitudes by Knuth's algorithm D (The Art of Computer
+	 * Programming, volume 2, section 4.3.1). Both operands are shifted so
+	 * that the top limb of the divisor has its high bit set; then the top
+	 * two limbs of the remainder over the top limb of the divisor
+	 * estimate each limb of the quotient to within two.
+	 */
+	void bigint::divide(const magnitude_type& a, const magnitude_type& b,
+	                    magnitude_type& quotient, magnitude_type& remainder)
+	{
+		const std::size_t m = a.size();
+		const std::size_t n = b.size();
+		assert(n >= 2 && m >= n);
+		const std::uint64_t base = std::uint64_t(1) << limb_bits;
+		const unsigned int shift = leading_zeros(b[n - 1]);
+
+		magnitude_type v(n);
+		for (std::size_t i = n - 1; i > 0; i--)
+			v[i] = shift == 0 ? b[i] : b[i] << shift | b[i - 1] >> (limb_bits - shift);
+		v[0] = b[0] << shift;
+
+		magnitude_type u(m + 1);
+		u[m] = shift == 0 ? 0 : a[m - 1] >> (limb_bits - shift);
+		for (std::size_t i = m - 1; i > 0; i--)
+			u[i] = shift == 0 ? a[i] : a[i] << shift | a[i - 1] >> (limb_bits - shift);
+		u[0] = a[0] << shift;
+
+		quotient.assign(m - n + 1, 0);
+		for (std::size_t j = m - n + 1; j-- > 0; ) {
+			const std::uint64_t top = static_cast<std::uint64_t>(u[j + n]) << limb_bits | u[j + n - 1];
+			std::uint64_t q = top / v[n - 1];
+			std::uint64_t r = top % v[n - 1];
+			while (q >= base || q * v[n - 2] > (r << limb_bits | u[j + n - 2])) {
+				q--;
+				r += v[n - 1];
+				if (r >= base)
+					break;
+			}
+
+			// subtract q times the divisor
+			std::int64_t borrow = 0;
+			std::int64_t t;
+			for (std::size_t i = 0; i < n; i++) {
+				const std::uint64_t p = q * v[i];
+				t = static_cast<std::int64_t>(u[i + j]) - borrow
+				    - static_cast<std::int64_t>(p & (base - 1));
+				u[i + j] = static_cast<limb_type>(t);
+				borrow = static_cast<std::int64_t>(p >> limb_bits) - (t >> limb_bits);
+			}
+			t = static_cast<std::int64_t>(u[j + n]) - borrow;
+			u[j + n] = static_cast<limb_type>(t);
+
+			// the estimate was one too large: add the divisor back
+			if (t < 0) {
+				q--;
+				std::uint64_t carry = 0;
+				for (std::size_t i = 0; i < n; i++) {
+					carry += static_cast<std::uint64_t>(u[i + j]) + v[i];
+					u[i + j] = static_cast<limb_type>(carry);
+					carry >>= limb_bits;
+				}
+				u[j + n] = static_cast<limb_type>(u[j + n] + carry);
+			}
+			quotient[j] = static_cast<limb_type>(q);
+		}
+
+		remainder.assign(n, 0);
+		for (std::size_t i = 0; i < n; i++)
+			remainder[i] = shift == 0 ? u[i] : u[i] >> shift | u[i + 1] << (limb_bits - shift);
+	}
+
+	bigint::limb_type bigint::divide(magnitude_type& a, limb_type b) noexcept {
+		std::uint64_t remainder = 0;
+		for (std::size_t i = a.size(); i-- > 0; ) {
+			const std::uint64_t current = remainder << limb_bits | a[i];
+			a[i] = static_cast<limb_type>(current / b);
+			remainder = current % b;
+		}
+		return static_cast<limb_type>(remainder);
+	}
+
+	void bigint::multiply_add(magnitude_type& a, limb_type b, limb_type c) {
+		std::uint64_t carry = c;
+		for (limb_type& limb : a) {
+			carry += static_cast<std::uint64_t>(limb) * b;
+			limb = static_cast<limb_type>(carry);
+			carry >>= limb_bits;
+		}
+		if (carry != 0)
+			a.push_back(static_cast<limb_type>(carry));
+	}
+
+	bigint bigint::sum(const bigint& a, const bigint& b, bool negate_b) {
+		std::int64_t result;
+		if (a._limbs.empty() && b._limbs.empty()
+		    && !(negate_b ? small_policy::subtract(a._small, b._small, result)
+		                  : small_policy::add(a._small, b._small, result)))
+			return bigint(static_cast<long long>(result));
+
+		const bool a_negative = a.is_negative();
+		const bool b_negative = b.is_negative() != negate_b;
+		magnitude_type a_magnitude = magnitude(a);
+		magnitude_type b_magnitude = magnitude(b);
+		if (a_negative == b_negative) {
+			add(a_magnitude, b_magnitude);
+			return bigint(a_negative, std::move(a_magnitude));
+		}
+		if (compare(a_magnitude, b_magnitude) >= 0) {
+			subtract(a_magnitude, b_magnitude);
+			return bigint(a_negative, std::move(a_magnitude));
+		}
+		subtract(b_magnitude, a_magnitude);
+		return bigint(b_negative, std::move(b_magnitude));
+	}
+} // namespace calc
@@ -0,0 +1,214 @@
+/**
+ * @file		bigint.hpp
+ * Contains type declarations for arbitrary-precision integers.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_BIGINT_HPP
+#define CALC_BIGINT_HPP
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "integer_policy.hpp"
+
+namespace calc {
+	/**
+	 * Represents an integer of any size. A value that fits in 64 bits is
+	 * stored inline, and arithmetic on such values costs one overflow
+	 * check; other values are stored as a sign and an array of 32-bit
+	 * limbs on the heap. Every value has one representation, so a result
+	 * that fits in 64 bits again is stored inline again.
+	 */
+	class bigint {
+	public:
+		typedef std::uint32_t limb_type;
+
+		bigint() noexcept : _small(0), _negative(false), _limbs() {}
+
+		bigint(int v) noexcept : bigint(static_cast<long long>(v)) {}
+
+		bigint(long v) noexcept : bigint(static_cast<long long>(v)) {}
+
+		bigint(long long v) noexcept :
+			_small(static_cast<std::int64_t>(v)), _negative(false), _limbs()
+		{}
+
+#if HAVE_INT128
+		bigint(__int128 v);
+#endif
+
+		/**
+		 * Converts a string of decimal digits.
+		 * @param first		The first digit.
+		 * @param last		The end of the digits.
+		 * @return			The value of the digits.
+		 */
+		template <typename CharT>
+		static bigint from_digits(const CharT* first, const CharT* last);
+
+		bool is_zero() const noexcept {
+			return this->_limbs.empty() && this->_small == 0;
+		}
+
+		bool is_negative() const noexcept {
+			return this->_limbs.empty() ? this->_small < 0 : this->_negative;
+		}
+
+		/// Returns @c true if the value is stored inline.
+		bool is_small() const noexcept {
+			return this->_limbs.empty();
+		}
+
+		/**
+		 * Converts to the integer type of an integer policy.
+		 * @param result	The value, if it is representable.
+		 * @return			@c false if the value is not representable.
+		 */
+		template <class Policy>
+		bool narrow(typename Policy::value_type& result) const noexcept;
+
+		std::string to_string() const;
+
+		/**
+		 * Compares two integers.
+		 * @return	A negative number, zero, or a positive number if @p a is
+		 * 			less than, equal to, or greater than @p b.
+		 */
+		static int compare(const bigint& a, const bigint& b) noexcept;
+
+		bigint operator-() const;
+
+		bigint& operator+=(const bigint& other);
+		bigint& operator-=(const bigint& other);
+		bigint& operator*=(const bigint& other);
+
+		/**
+		 * Divides by @p other, rounding toward zero.
+		 * @throw std::domain_error	If @p other is zero.
+		 */
+		bigint& operator/=(const bigint& other);
+
+		/**
+		 * Takes the remainder of division by @p other, which has the sign
+		 * of the dividend.
+		 * @throw std::domain_error	If @p other is zero.
+		 */
+		bigint& operator%=(const bigint& other);
+
+		/**
+		 * Divides @p a by @p b, rounding toward zero.
+		 * @param quotient	The quotient.
+		 * @param remainder	The remainder, which has the sign of @p a.
+		 * @throw std::domain_error	If @p b is zero.
+		 */
+		static void divide(const bigint& a, const bigint& b, bigint& quotient,
+		                   bigint& remainder);
+
+	private:
+		typedef std::vector<limb_type> magnitude_type;
+
+		/// The value, if _limbs is empty.
+		std::int64_t _small;
+		/// The sign, if _limbs is not empty.
+		bool _negative;
+		/// The magnitude, least significant limb first, without leading
+		/// zero limbs, of a value that does not fit in 64 bits.
+		magnitude_type _limbs;
+
+		bigint(bool negative, magnitude_type&& magnitude);
+
+		static magnitude_type magnitude(const bigint& v);
+		static magnitude_type magnitude(std::uint64_t v);
+		static void add(magnitude_type& a, const magnitude_type& b);
+		static void subtract(magnitude_type& a, const magnitude_type& b) noexcept;
+		static int compare(const magnitude_type& a, const magnitude_type& b) noexcept;
+		static magnitude_type multiply(const magnitude_type& a, const magnitude_type& b);
+		static void divide(const magnitude_type& a, const magnitude_type& b,
+		                   magnitude_type& quotient, magnitude_type& remainder);
+		static limb_type divide(magnitude_type& a, limb_type b) noexcept;
+		static void multiply_add(magnitude_type& a, limb_type b, limb_type c);
+
+		static bigint sum(const bigint& a, const bigint& b, bool negate_b);
+	};
+
+	inline bigint operator+(bigint a, const bigint& b) { return a += b; }
+	inline bigint operator-(bigint a, const bigint& b) { return a -= b; }
+	inline bigint operator*(bigint a, const bigint& b) { return a *= b; }
+	inline bigint operator/(bigint a, const bigint& b) { return a /= b; }
+	inline bigint operator%(bigint a, const bigint& b) { return a %= b; }
+
+	inline bool operator==(const bigint& a, const bigint& b) noexcept { return bigint::compare(a, b) == 0; }
+	inline bool operator!=(const bigint& a, const bigint& b) noexcept { return bigint::compare(a, b) != 0; }
+	inline bool operator<(const bigint& a, const bigint& b) noexcept { return bigint::compare(a, b) < 0; }
+	inline bool operator>(const bigint& a, const bigint& b) noexcept { return bigint::compare(a, b) > 0; }
+	inline bool operator<=(const bigint& a, const bigint& b) noexcept { return bigint::compare(a, b) <= 0; }
+	inline bool operator>=(const bigint& a, const bigint& b) noexcept { return bigint::compare(a, b) >= 0; }
+
+	template <typename CharT>
+	bigint bigint::from_digits(const CharT* first, const CharT* last) {
+		std::int64_t small;
+		if (integer_policy<64>::from_digits(first, last, small))
+			return bigint(static_cast<long long>(small));
+
+		// nine decimal digits fit in a limb
+		magnitude_type result;
+		while (first != last) {
+			limb_type chunk = 0, scale = 1;
+			for (int i = 0; i < 9 && first != last; i++, ++first) {
+				chunk = chunk * 10 + static_cast<limb_type>(*first - CharT('0'));
+				scale *= 10;
+			}
+			multiply_add(result, scale, chunk);
+		}
+		return bigint(false, std::move(result));
+	}
+
+	template <class Policy>
+	bool bigint::narrow(typename Policy::value_type& result) const noexcept {
+		typedef typename Policy::value_type T;
+		typedef typename Policy::unsigned_type U;
+
+		if (this->_limbs.empty()) {
+			if (sizeof(T) < sizeof(std::int64_t)
+			    && (this->_small < static_cast<std::int64_t>(Policy::min())
+			        || this->_small > static_cast<std::int64_t>(Policy::max())))
+				return false;
+			result = static_cast<T>(this->_small);
+			return true;
+		}
+		if (this->_limbs.size() * sizeof(limb_type) > sizeof(T))
+			return false;
+
+		U value = 0;
+		for (std::size_t i = this->_limbs.size(); i-- > 0; )
+			// in two steps, which stay defined when U is as wide as a limb
+			value = static_cast<U>(static_cast<U>(value << 16) << 16) | this->_limbs[i];
+		const U limit = static_cast<U>(Policy::max()) + (this->_negative ? 1 : 0);
+		if (value > limit)
+			return false;
+		result = this->_negative ? static_cast<T>(U(0) - value) : static_cast<T>(value);
+		return true;
+	}
+
+	template <typename CharT, class Traits>
+	inline std::basic_ostream<CharT, Traits>&
+	operator<<(std::basic_ostream<CharT, Traits>& out, const bigint& v) {
+		const std::string digits = v.to_string();
+		std::basic_string<CharT, Traits> s;
+		for (char c : digits)
+			s.push_back(out.widen(c));
+		return out << s;
+	}
+} // namespace calc
+
+#endif // CALC_BIGINT_HPP
@@ -0,0 +1,242 @@
+/**
+ * @file		c_emitter.cpp
+ * Contains type definitions for emitting C source code.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#include "c_emitter.hpp"
+
+#include <stdexcept>
+
+namespace calc {
+	/**
+	 * Builds a C expression from a calculator expression. Integer operators
+	 * are routed through the calc_* helper functions declared in the
+	 * prologue so that overflow wraps around instead of being undefined.
+	 */
+	class c_expression_builder : public expr_visitor {
+	public:
+		std::string build(const expr& e) {
+			e.accept(*this);
+			return this->_result;
+		}
+
+		void visit(const positive_expr& e) {
+			this->_result = this->build(*e.operand());
+		}
+
+		void visit(const negative_expr& e) {
+			this->_result = "calc_neg(" + this->build(*e.operand()) + ")";
+		}
+
+		void visit(const addition_expr& e) {
+			this->call("calc_add", e);
+		}
+
+		void visit(const subtraction_expr& e) {
+			this->call("calc_sub", e);
+		}
+
+		void visit(const multiplication_expr& e) {
+			this->call("calc_mul", e);
+		}
+
+		void visit(const division_expr& e) {
+			this->call("calc_div", e, true);
+		}
+
+		void visit(const modulus_expr& e) {
+			this->call("calc_mod", e, true);
+		}
+
+		void visit(const equal_expr& e) {
+			this->infix("==", e);
+		}
+
+		void visit(const not_equal_expr& e) {
+			this->infix("!=", e);
+		}
+
+		void visit(const less_expr& e) {
+			this->infix("<", e);
+		}
+
+		void visit(const greater_expr& e) {
+			this->infix(">", e);
+		}
+
+		void visit(const less_equal_expr& e) {
+			this->infix("<=", e);
+		}
+
+		void visit(const greater_equal_expr& e) {
+			this->infix(">=", e);
+		}
+
+		void visit(const logical_not_expr& e) {
+			this->_result = "!" + this->build(*e.operand());
+		}
+
+		// calc evaluates both operands of a logical operator, so that
+		// division by zero in either one is reported; booleans are 0 or 1,
+		// so the bitwise operators compute the same values without
+		// short-circuiting
+		void visit(const logical_and_expr& e) {
+			this->infix("&", e);
+		}
+
+		void visit(const logical_or_expr& e) {
+			this->infix("|", e);
+		}
+
+		void visit(const boolean& e) {
+			this->_result = e.to_bool() ? "1" : "0";
+		}
+
+		void visit(const integer& e) {
+			this->_result = default_integer_policy::to_string(e.to_integer());
+		}
+
+		void visit(const error_expr& e) {
+			throw std::invalid_argument("calc::c_emitter::emit");
+		}
+
+		void visit(const big_integer& e) {
+			// the emitted code does 32-bit arithmetic
+			throw std::overflow_error("calc::c_emitter::emit");
+		}
+
+	private:
+		std::string _result;
+
+		void call(const char* function, const binary_expr& e,
+		          bool has_status = false)
+		{
+			const std::string left = this->build(*e.left_operand());
+			const std::string right = this->build(*e.right_operand());
+			this->_result = std::string(function) + "(" + left + ", " + right
+			                + (has_status ? ", status)" : ")");
+		}
+
+		void infix(const char* op, const binary_expr& e) {
+			const std::string left = this->build(*e.left_operand());
+			const std::string right = this->build(*e.right_operand());
+			this->_result = "(" + left + " " + op + " " + right + ")";
+		}
+	};
+
+	c_emitter::c_emitter(std::ostream& out) : _out(out), _rules() {}
+
+	void c_emitter::emit_prologue() {
+		this->_out <<
+			"/* Generated by " PACKAGE_STRING ". */\n"
+			"\n"
+			"#include <stddef.h>\n"
+			"#include <stdint.h>\n"
+			"\n"
+			"enum calc_type { CALC_BOOLEAN, CALC_INTEGER };\n"
+			"enum calc_status { CALC_OK, CALC_DIVISION_BY_ZERO };\n"
+			"\n"
+			"#if defined(__GNUC__)\n"
+			"#define CALC_UNUSED __attribute__((unused))\n"
+			"#else\n"
+			"#define CALC_UNUSED\n"
+			"#endif\n"
+			"\n"
+			"struct calc_rule {\n"
+			"\tconst char *name;\n"
+			"\tenum calc_type type;\n"
+			"\tint32_t (*function)(int *status);\n"
+			"};\n"
+			"\n"
+			"CALC_UNUSED static int32_t calc_neg(int32_t a) {\n"
+			"\treturn (int32_t)(0u - (uint32_t)a);\n"
+			"}\n"
+			"\n"
+			"CALC_UNUSED static int32_t calc_add(int32_t a, int32_t b) {\n"
+			"\treturn (int32_t)((uint32_t)a + (uint32_t)b);\n"
+			"}\n"
+			"\n"
+			"CALC_UNUSED static int32_t calc_sub(int32_t a, int32_t b) {\n"
+			"\treturn (int32_t)((uint32_t)a - (uint32_t)b);\n"
+			"}\n"
+			"\n"
+			"CALC_UNUSED static int32_t calc_mul(int32_t a, int32_t b) {\n"
+			"\treturn (int32_t)((uint32_t)a * (uint32_t)b);\n"
+			"}\n"
+			"\n"
+			"CALC_UNUSED static int32_t calc_div(int32_t a, int32_t b, int *status) {\n"
+			"\tif (b == 0) {\n"
+			"\t\t*status = CALC_DIVISION_BY_ZERO;\n"
+			"\t\treturn 0;\n"
+			"\t}\n"
+			"\treturn b == -1 ? calc_neg(a) : a / b;\n"
+			"}\n"
+			"\n"
+			"CALC_UNUSED static int32_t calc_mod(int32_t a, int32_t b, int *status) {\n"
+			"\tif (b == 0) {\n"
+			"\t\t*status = CALC_DIVISION_BY_ZERO;\n"
+			"\t\treturn 0;\n"
+			"\t}\n"
+			"\treturn b == -1 ? 0 : a % b;\n"
+			"}\n";
+	}
+
+	std::string c_emitter::emit(const expr& e, std::size_t n) {
+		const std::string name = "expr_" + std::to_string(n);
+		const bool is_boolean = static_type(e) == boolean_type::instance;
+
+		c_expression_builder builder;
+		const std::string result = builder.build(e);
+
+		this->_out << '\n'
+		           << "static int32_t " << name << "(int *status) {\n"
+		           << "\t(void)status;\n"
+		           << "\treturn " << result << ";\n"
+		           << "}\n";
+		this->_rules.push_back({name, is_boolean});
+
+		return name;
+	}
+
+	void c_emitter::emit_epilogue() {
+		this->_out << '\n'
+		           << "const struct calc_rule calc_rules[] = {\n";
+		for (const rule& i : this->_rules)
+			this->_out << "\t{\"" << i.name << "\", "
+			           << (i.is_boolean ? "CALC_BOOLEAN" : "CALC_INTEGER")
+			           << ", " << i.name << "},\n";
+		// the terminating entry keeps the array non-empty for empty scripts
+		this->_out << "\t{NULL, CALC_INTEGER, NULL}\n"
+		           << "};\n"
+		           << '\n'
+		           << "const size_t calc_rule_count = " << this->_rules.size() << ";\n";
+
+		this->_out <<
+			"\n"
+			"#ifdef CALC_RULES_MAIN\n"
+			"#include <stdio.h>\n"
+			"\n"
+			"int main(void) {\n"
+			"\tsize_t i;\n"
+			"\n"
+			"\tfor (i = 0; i < calc_rule_count; i++) {\n"
+			"\t\tint status = CALC_OK;\n"
+			"\t\tconst int32_t value = calc_rules[i].function(&status);\n"
+			"\n"
+			"\t\tif (status == CALC_DIVISION_BY_ZERO)\n"
+			"\t\t\tfprintf(stderr, \"%s: Attempt to divide by zero.\\n\", calc_rules[i].name);\n"
+			"\t\telse if (calc_rules[i].type == CALC_BOOLEAN)\n"
+			"\t\t\tputs(value ? \"true\" : \"false\");\n"
+			"\t\telse\n"
+			"\t\t\tprintf(\"%ld\\n\", (long)value);\n"
+			"\t}\n"
+			"\n"
+			"\treturn 0;\n"
+			"}\n"
+			"#endif\n";
+	}
+} // namespace calc
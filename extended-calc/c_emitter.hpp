@@ -0,0 +1,82 @@
+/**
+ * @file		c_emitter.hpp
+ * Contains type declarations for emitting C source code.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_C_EMITTER_HPP
+#define CALC_C_EMITTER_HPP
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "ast.hpp"
+
+namespace calc {
+	/**
+	 * Translates a script into a C translation unit. Each expression becomes
+	 * a function named @c expr_N, and a driver table named @c calc_rules
+	 * lists every function with the type of its result.
+	 *
+	 * The generated code keeps the semantics of the calculator: integer
+	 * arithmetic wraps around at 32 bits, both operands of logical operators
+	 * are evaluated, and division by zero stores @c CALC_DIVISION_BY_ZERO
+	 * through the function's @c status argument instead of trapping. Compiling the output with @c CALC_RULES_MAIN
+	 * defined adds a @c main() function that prints every result.
+	 */
+	class c_emitter {
+	public:
+		/**
+		 * Constructs an emitter that writes to an output stream.
+		 * @param out	An output stream.
+		 */
+		explicit c_emitter(std::ostream& out);
+
+		c_emitter(const c_emitter&) = delete;
+
+		c_emitter& operator=(const c_emitter&) = delete;
+
+		/**
+		 * Writes the header of the translation unit and the arithmetic
+		 * helper functions. Must be called once before the first call to
+		 * emit().
+		 */
+		void emit_prologue();
+
+		/**
+		 * Writes a function that computes the value of an expression.
+		 * @param e		An expression.
+		 * @param n		The number used to name the function.
+		 * @return		The name of the emitted function.
+		 * @throw		std::invalid_argument if an operand of @p e has the
+		 * 				wrong type, in which case nothing is written.
+		 * @throw		std::overflow_error if @p e contains a big_integer,
+		 * 				in which case nothing is written.
+		 */
+		std::string emit(const expr& e, std::size_t n);
+
+		/**
+		 * Writes the driver table for every function emitted so far and the
+		 * optional @c main() function.
+		 */
+		void emit_epilogue();
+
+	private:
+		struct rule {
+			std::string name;
+			bool is_boolean;
+		};
+
+		std::ostream& _out;
+		std::vector<rule> _rules;
+	};
+} // namespace calc
+
+#endif // CALC_C_EMITTER_HPP
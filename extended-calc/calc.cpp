@@ -3,53 +3,460 @@
 #if HAVE_UNISTD_H
 #include <unistd.h>
 #endif
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 
+#include "ast_cache.hpp"
+#include "batch_evaluator.hpp"
+#include "c_emitter.hpp"
 #include "cli.hpp"
+#include "expr_dag.hpp"
+#include "histogram.hpp"
+#include "instrument.hpp"
+#include "llvm_emitter.hpp"
 #include "parser.hpp"
 
 #define LOG_EXPR(x) std::cout << #x << " = " << (x) << std::endl
 
+/// Statistics gathered for --stats. Latencies are in nanoseconds.
+struct run_stats {
+	calc::latency_histogram lex;
+	calc::latency_histogram parse;
+	calc::latency_histogram evaluate;
+	std::size_t expressions = 0;
+	std::size_t errors = 0;
+	std::chrono::steady_clock::time_point start;
+};
+
+static run_stats stats;
+static volatile std::sig_atomic_t stats_requested = 0;
+
+/// The number of expressions that --batch evaluates together.
+static const std::size_t batch_size = 4096;
+
+static std::uint64_t clock_ns() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Records the time between its construction and destruction, less the time
+ * spent lexing, into a histogram. The time spent lexing is recorded into a
+ * second histogram, if one is given. Does nothing if no histogram is given.
+ */
+class latency_timer {
+public:
+	explicit latency_timer(calc::latency_histogram* histogram,
+	                       calc::latency_histogram* lex_histogram = nullptr) :
+		_histogram(histogram), _lex_histogram(lex_histogram),
+		_start(histogram ? clock_ns() : 0),
+		_lex_start(histogram ? calc::phase_time(calc::phase::lex) : 0)
+	{}
+
+	latency_timer(const latency_timer&) = delete;
+
+	~latency_timer() {
+		if (!this->_histogram)
+			return;
+		const std::uint64_t elapsed = clock_ns() - this->_start;
+		const std::uint64_t lex = calc::phase_time(calc::phase::lex) - this->_lex_start;
+		this->_histogram->record(elapsed > lex ? elapsed - lex : 0);
+		if (this->_lex_histogram)
+			this->_lex_histogram->record(lex);
+	}
+
+	latency_timer& operator=(const latency_timer&) = delete;
+
+	/// Discards the measurement.
+	void cancel() noexcept {
+		this->_histogram = nullptr;
+	}
+
+private:
+	calc::latency_histogram* _histogram;
+	calc::latency_histogram* _lex_histogram;
+	std::uint64_t _start;
+	std::uint64_t _lex_start;
+};
+
+static void request_stats(int) {
+	stats_requested = 1;
+}
+
+static void print_stats(const calc::parser& parser, const calc::expr_dag& dag) {
+	const double seconds = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - stats.start).count();
+	const std::pair<const char*, const calc::latency_histogram*> rows[] = {
+#if ENABLE_INSTRUMENTATION
+		{"lex", &stats.lex},
+#endif
+		{"parse", &stats.parse},
+		{"evaluate", &stats.evaluate}
+	};
+	const double percentiles[] = {50.0, 90.0, 99.0, 99.9};
+	std::ostream& out = std::cerr;
+	const std::ios_base::fmtflags flags = out.flags();
+
+	out << std::fixed << std::setprecision(3)
+	    << std::left << std::setw(10) << "latency" << std::right
+	    << std::setw(10) << "count" << std::setw(12) << "p50 (us)"
+	    << std::setw(12) << "p90 (us)" << std::setw(12) << "p99 (us)"
+	    << std::setw(12) << "p99.9 (us)" << std::setw(12) << "max (us)"
+	    << std::setw(12) << "total (ms)" << '\n';
+	for (const auto& row : rows) {
+		out << std::left << std::setw(10) << row.first << std::right
+		    << std::setw(10) << row.second->count();
+		for (double p : percentiles)
+			out << std::setw(12) << row.second->percentile(p) / 1e3;
+		out << std::setw(12) << row.second->max() / 1e3
+		    << std::setw(12) << row.second->total() / 1e6 << '\n';
+	}
+#if !ENABLE_INSTRUMENTATION
+	out << "(lexing is included in parse; build with ENABLE_INSTRUMENTATION to separate it)\n";
+#endif
+
+	out << "bytes in:    " << parser.characters_read() << '\n'
+	    << "tokens:      " << parser.token_count() << '\n'
+	    << "expressions: " << stats.expressions << '\n'
+	    << "errors:      " << stats.errors << '\n';
+	if (calc::share_subexpressions())
+		out << "dag nodes:   " << dag.size() << " of " << dag.added_node_count() << '\n';
+	out << "wall time:   " << seconds << " s\n";
+	if (seconds > 0)
+		out << "throughput:  " << std::setprecision(1)
+		    << stats.expressions / seconds << " expressions/s, "
+		    << parser.characters_read() / seconds / 1e6 << " MB/s\n";
+	out.flags(flags);
+}
+
+/**
+ * Evaluates the expressions of a batch, and prints their values or errors
+ * in order.
+ */
+static void flush_batch(calc::batch_evaluator& batch,
+                        calc::latency_histogram* evaluate_histogram)
+{
+	if (batch.empty())
+		return;
+	{
+		// a batch is one sample
+		latency_timer timer(evaluate_histogram);
+		CALC_PHASE_SCOPE(evaluate);
+		batch.evaluate();
+	}
+
+	CALC_PHASE_SCOPE(output);
+	for (std::size_t i = 0; i < batch.size(); i++) {
+		try {
+			std::cout << std::boolalpha << *batch.value(i) << '\n';
+		}
+		catch (const std::invalid_argument& exception) {
+			stats.errors++;
+			std::cout.flush();
+			calc::report_error("Invalid operand types.");
+		}
+		catch (const std::domain_error& exception) {
+			stats.errors++;
+			std::cout.flush();
+			calc::report_error("Attempt to divide by zero.");
+		}
+		catch (const std::overflow_error& exception) {
+			stats.errors++;
+			std::cout.flush();
+			calc::report_error("Integer overflow.");
+		}
+	}
+	std::cout.flush();
+	batch.clear();
+}
+
+static int load_cache(const char* path) {
+	try {
+		calc::ast_cache_reader cache(path);
+
+		for (std::size_t i = 0; i < cache.size(); i++) {
+			try {
+				std::unique_ptr<calc::value> value = cache.value(i);
+				std::cout << std::boolalpha << *value.get() << '\n';
+			}
+			catch (const std::invalid_argument& exception) {
+				calc::report_error("Invalid operand types.");
+			}
+			catch (const std::domain_error& exception) {
+				calc::report_error("Attempt to divide by zero.");
+			}
+			catch (const std::overflow_error& exception) {
+				calc::report_error("Integer overflow.");
+			}
+		}
+		std::cout.flush();
+	}
+	catch (const calc::ast_cache_error& exception) {
+		calc::report_error("%s", exception.what());
+		return 1;
+	}
+
+	return 0;
+}
+
 int main(int argc, char* argv[]) {
 	calc::init(argc, argv);
 
+	if (calc::print_alloc_stats()) {
+#if ENABLE_INSTRUMENTATION
+		calc::enable_allocation_tracking();
+#else
+		calc::report_error("--alloc-stats requires a build with ENABLE_INSTRUMENTATION.");
+		return 2;
+#endif
+	}
+
+#if !ENABLE_INSTRUMENTATION
+	if (calc::trace_path()) {
+		calc::report_error("--trace requires a build with ENABLE_INSTRUMENTATION.");
+		return 2;
+	}
+#endif
+
+	if (calc::print_stats()) {
+#if ENABLE_INSTRUMENTATION
+		calc::start_phase_timing();
+#endif
+#ifdef SIGUSR1
+		std::signal(SIGUSR1, request_stats);
+#endif
+	}
+
+#if CALC_INTEGER_WIDTH != 32
+	// the emitted code does 32-bit arithmetic
+	if (calc::mode() == calc::run_mode::emit_llvm || calc::mode() == calc::run_mode::emit_c) {
+		calc::report_error("--emit-llvm and --emit-c require a build with CALC_INTEGER_WIDTH=32.");
+		return 2;
+	}
+#endif
+
+#if ENABLE_BIGINT
+	// the graph and the batch hold integer_t, and cannot promote
+	if (calc::batch() || calc::share_subexpressions()) {
+		calc::report_error("--batch and --cse require a build without ENABLE_BIGINT.");
+		return 2;
+	}
+#endif
+
+	if (calc::batch() && calc::share_subexpressions()) {
+		calc::report_error("--batch cannot be combined with --cse.");
+		return 2;
+	}
+
 #if HAVE_UNISTD_H
-	if (optind < argc) {
+	const int arg_index = optind;
 #else
-	if (argc > 1) {
+	const int arg_index = 1;
 #endif
+
+	if (argc - arg_index > 1) {
 		calc::report_error("Too many arguments.");
 		return 2;
 	}
 
+	if (calc::mode() == calc::run_mode::load_cache) {
+		if (arg_index < argc) {
+			calc::report_error("--load-cache cannot be combined with an input file.");
+			return 2;
+		}
+		return load_cache(calc::cache_path());
+	}
+
+	std::ifstream in;
+	std::streambuf* buffer = std::cin.rdbuf();
+
+	if (arg_index < argc) {
+		in.open(argv[arg_index]);
+		if (!in) {
+			calc::report_error("Could not open %s.", argv[arg_index]);
+			return 1;
+		}
+		buffer = in.rdbuf();
+	}
+
+	const bool reads_stdin = buffer == std::cin.rdbuf();
+
+#if ENABLE_INSTRUMENTATION
+	std::ofstream trace_out;
+	std::unique_ptr<calc::phase_streambuf> phase_buffer;
+
+	if (calc::trace_path()) {
+		trace_out.open(calc::trace_path());
+		if (!trace_out) {
+			calc::report_error("Could not open %s.", calc::trace_path());
+			return 1;
+		}
+		calc::start_tracing();
+		phase_buffer.reset(new calc::phase_streambuf(
+			buffer, calc::is_interactive() && reads_stdin));
+		buffer = phase_buffer.get();
+	}
+#endif
+
+	int status = 0;
+	std::size_t expr_count = 0;
+
 	try {
-		calc::parser parser(std::cin);
+		calc::parser parser(buffer);
+		if (calc::utf8())
+			parser.utf8(true);
+		if (calc::all_errors())
+			parser.recover(true);
+		calc::llvm_emitter llvm_emitter(std::cout);
+		calc::c_emitter c_emitter(std::cout);
+		calc::ast_cache_writer cache_writer(true);
+		// with --cse, the expressions of the whole script share their
+		// common subexpressions and the values of them
+		calc::expr_dag dag;
+		// with --batch, expressions are evaluated a batch at a time, and
+		// the batch is flushed before any error is reported so that the
+		// output stays in order
+		calc::batch_evaluator batch;
+		const bool flush_each = calc::is_interactive() && reads_stdin;
 
+		calc::latency_histogram* const lex_histogram =
+			calc::print_stats() ? &stats.lex : nullptr;
+		calc::latency_histogram* const parse_histogram =
+			calc::print_stats() ? &stats.parse : nullptr;
+		calc::latency_histogram* const evaluate_histogram =
+			calc::print_stats() ? &stats.evaluate : nullptr;
+
+		if (calc::mode() == calc::run_mode::emit_llvm)
+			llvm_emitter.emit_prologue();
+		else if (calc::mode() == calc::run_mode::emit_c)
+			c_emitter.emit_prologue();
+
+		stats.start = std::chrono::steady_clock::now();
 		while (true) {
-			if (calc::is_interactive())
+			if (stats_requested) {
+				stats_requested = 0;
+				print_stats(parser, dag);
+			}
+			if (calc::is_interactive() && reads_stdin)
 				calc::show_prompt();
 			try {
-				std::unique_ptr<const calc::expr> expr = parser.next_expr();
-				if (!expr)
-					break;
-				std::unique_ptr<calc::value> value = expr->value();
-				std::cout << std::boolalpha << *value.get() << std::endl;
-			}
-			catch (const calc::parse_error& exception) {
-				calc::report_error(exception);
+				// number expressions by input line, including erroneous ones
+				expr_count++;
+#if ENABLE_INSTRUMENTATION
+				calc::set_trace_expression(expr_count);
+#endif
+				std::unique_ptr<const calc::expr> expr;
+				{
+					latency_timer timer(parse_histogram, lex_histogram);
+					calc::parse_result result = parser.try_next_expr();
+					if (!result) {
+						flush_batch(batch, evaluate_histogram);
+						stats.expressions++;
+						stats.errors++;
+						calc::report_error(result.error());
+						continue;
+					}
+					expr = std::move(result.value());
+					if (!expr) {
+						timer.cancel();
+						break;
+					}
+					stats.expressions++;
+				}
+				// in recovery mode, the tree of a line with errors is only
+				// good for finding them
+				if (!parser.last_errors().empty()) {
+					flush_batch(batch, evaluate_histogram);
+					for (const calc::parse_diagnostic* diagnostic : parser.last_errors()) {
+						stats.errors++;
+						calc::report_error(*diagnostic);
+					}
+					continue;
+				}
+				switch (calc::mode()) {
+					case calc::run_mode::evaluate: {
+						if (calc::batch()) {
+							batch.add(*expr);
+							if (batch.size() == batch_size || flush_each)
+								flush_batch(batch, evaluate_histogram);
+							break;
+						}
+						std::unique_ptr<calc::value> value;
+						{
+							latency_timer timer(evaluate_histogram);
+							CALC_PHASE_SCOPE(evaluate);
+							if (calc::share_subexpressions())
+								value = dag.value(dag.add(*expr));
+							else
+								value = expr->value();
+						}
+						CALC_PHASE_SCOPE(output);
+						std::cout << std::boolalpha << *value.get() << std::endl;
+						break;
+					}
+					case calc::run_mode::emit_llvm:
+						llvm_emitter.emit(*expr, expr_count);
+						break;
+					case calc::run_mode::emit_c:
+						c_emitter.emit(*expr, expr_count);
+						break;
+					case calc::run_mode::compile_cache:
+						cache_writer.add(*expr, parser.last_extent().start_offset(),
+						                 parser.last_extent().end_offset());
+						break;
+					case calc::run_mode::load_cache:
+						break;
+				}
 			}
 			catch (const std::invalid_argument& exception) {
+				stats.errors++;
 				calc::report_error("Invalid operand types.");
 			}
 			catch (const std::domain_error& exception) {
+				stats.errors++;
 				calc::report_error("Attempt to divide by zero.");
 			}
+			catch (const std::overflow_error& exception) {
+				stats.errors++;
+				calc::report_error("Integer overflow.");
+			}
 		}
+
+		flush_batch(batch, evaluate_histogram);
+
+		if (calc::print_stats())
+			print_stats(parser, dag);
+
+		if (calc::mode() == calc::run_mode::emit_c)
+			c_emitter.emit_epilogue();
+		else if (calc::mode() == calc::run_mode::compile_cache)
+			cache_writer.write(calc::cache_path());
+	}
+	catch (const calc::ast_cache_error& exception) {
+		calc::report_error("%s", exception.what());
+		status = 1;
 	}
 	catch (const std::ios_base::failure& exception) {
 		calc::report_error("An unexpected I/O error occurred.");
-		return 1;
+		status = 1;
 	}
 
-	return 0;
+#if ENABLE_INSTRUMENTATION
+	// the last call to next_expr() found the end of the script
+	if (calc::print_alloc_stats())
+		calc::print_allocation_stats(std::cerr, expr_count ? expr_count - 1 : 0);
+	if (calc::trace_path()) {
+		calc::write_trace(trace_out);
+		trace_out.close();
+		if (!trace_out) {
+			calc::report_error("Could not write %s.", calc::trace_path());
+			status = 1;
+		}
+	}
+#endif
+
+	return status;
 }
@@ -0,0 +1,141 @@
+#include "config.hpp"
+
+#if HAVE_GETOPT_H
+#include <getopt.h>
+#endif
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "cli.hpp"
+#include "generator.hpp"
+
+/// The number of bytes generated before each write to the standard output.
+static const std::size_t buffer_size = 1 << 20;
+
+static void usage(std::ostream& out) {
+	out << "Usage: calc_gen [OPTION]...\n"
+	    << "Writes a reproducible corpus of random expressions to the standard\n"
+	    << "output, one per line.\n"
+	    << "\n"
+	    << "  -n, --lines=N          number of lines (default 1000)\n"
+	    << "  -c, --bytes=N          stop after at least N bytes instead\n"
+	    << "  -s, --seed=N           pseudorandom seed (default 1)\n"
+	    << "  -d, --depth=N          maximum tree depth (default 4)\n"
+	    << "  -w, --width=N          maximum operands per operator chain (default 3)\n"
+	    << "  -m, --mix=SPEC         operator weights, e.g. additive:4,logical:0;\n"
+	    << "                         kinds are additive, multiplicative, unary,\n"
+	    << "                         ordering, equality and logical\n"
+	    << "  -b, --boolean-ratio=P  probability of a boolean expression (default 0.5)\n"
+	    << "  -l, --digits=N         maximum digits per integer literal (default 4)\n"
+	    << "  -W, --whitespace=P     probability of a blank between tokens (default 0.8)\n"
+	    << "  -e, --errors=P         probability of an erroneous line (default 0)\n"
+	    << "  -h, --help             display this help and exit\n";
+}
+
+static bool parse_probability(const char* s, double& p) {
+	char* end = nullptr;
+	p = std::strtod(s, &end);
+	return *s != '\0' && *end == '\0' && 0.0 <= p && p <= 1.0;
+}
+
+int main(int argc, char* argv[]) {
+	calc::init(argv[0]);
+
+	calc::generator_options options;
+	unsigned long long lines = 1000;
+	unsigned long long bytes = 0;
+
+#if HAVE_GETOPT_H
+	static const struct option long_options[] = {
+		{"lines", required_argument, nullptr, 'n'},
+		{"bytes", required_argument, nullptr, 'c'},
+		{"seed", required_argument, nullptr, 's'},
+		{"depth", required_argument, nullptr, 'd'},
+		{"width", required_argument, nullptr, 'w'},
+		{"mix", required_argument, nullptr, 'm'},
+		{"boolean-ratio", required_argument, nullptr, 'b'},
+		{"digits", required_argument, nullptr, 'l'},
+		{"whitespace", required_argument, nullptr, 'W'},
+		{"errors", required_argument, nullptr, 'e'},
+		{"help", no_argument, nullptr, 'h'},
+		{nullptr, 0, nullptr, 0}
+	};
+	int c;
+
+	while ((c = getopt_long(argc, argv, "n:c:s:d:w:m:b:l:W:e:h", long_options,
+	                        nullptr)) != -1)
+	{
+		bool valid = true;
+
+		switch (c) {
+			case 'n':
+				lines = std::strtoull(optarg, nullptr, 10);
+				bytes = 0;
+				break;
+			case 'c':
+				bytes = std::strtoull(optarg, nullptr, 10);
+				break;
+			case 's':
+				options.seed = std::strtoull(optarg, nullptr, 0);
+				break;
+			case 'd':
+				options.max_depth = std::strtoul(optarg, nullptr, 10);
+				break;
+			case 'w':
+				options.max_width = std::strtoul(optarg, nullptr, 10);
+				break;
+			case 'm':
+				valid = options.mix.parse(optarg);
+				break;
+			case 'b':
+				valid = parse_probability(optarg, options.boolean_ratio);
+				break;
+			case 'l':
+				options.max_digits = std::strtoul(optarg, nullptr, 10);
+				break;
+			case 'W':
+				valid = parse_probability(optarg, options.whitespace_density);
+				break;
+			case 'e':
+				valid = parse_probability(optarg, options.error_rate);
+				break;
+			case 'h':
+				usage(std::cout);
+				return 0;
+			default:
+				usage(std::cerr);
+				return 2;
+		}
+
+		if (!valid) {
+			calc::report_error("invalid argument '%s' for '%s'", optarg,
+			                   argv[optind - 1]);
+			return 2;
+		}
+	}
+#endif
+
+	calc::expr_generator generator(options);
+	std::string buffer;
+	unsigned long long written = 0;
+
+	buffer.reserve(buffer_size + 4096);
+	for (unsigned long long i = 0; bytes ? written < bytes : i < lines; i++) {
+		const std::size_t before = buffer.size();
+		generator.generate_line(buffer);
+		written += buffer.size() - before;
+
+		if (buffer.size() >= buffer_size) {
+			if (std::fwrite(buffer.data(), 1, buffer.size(), stdout) != buffer.size())
+				return 1;
+			buffer.clear();
+		}
+	}
+
+	if (std::fwrite(buffer.data(), 1, buffer.size(), stdout) != buffer.size()
+	    || std::fflush(stdout) != 0)
+		return 1;
+	return 0;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file		char_class.hpp
+ * Contains a compile-time character classification table for the classic
+ * locale.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_CHAR_CLASS_HPP
+#define CALC_CHAR_CLASS_HPP
+
+#include "config.hpp"
+
+namespace calc {
+	/**
+	 * Classifies the 256 values of @c char the way the classic ("C") locale
+	 * does, with a single table lookup instead of a call through a ctype
+	 * facet. Characters outside of ASCII belong to no class.
+	 */
+	class classic_char_table {
+	public:
+		static constexpr unsigned char blank = 1 << 0;
+		static constexpr unsigned char space = 1 << 1;
+		static constexpr unsigned char digit = 1 << 2;
+		static constexpr unsigned char newline = 1 << 3;
+
+		constexpr classic_char_table() noexcept : _classes() {
+			for (int c = 0; c < 256; c++)
+				this->_classes[c] = classify(c);
+		}
+
+		constexpr bool is(unsigned char mask, char c) const noexcept {
+			return (this->_classes[static_cast<unsigned char>(c)] & mask) != 0;
+		}
+
+		/// Wider characters are classified only in the range of the table.
+		template <typename CharT>
+		constexpr bool is(unsigned char mask, CharT c) const noexcept {
+			return static_cast<unsigned long>(c) < 256
+				&& (this->_classes[static_cast<unsigned long>(c)] & mask) != 0;
+		}
+
+	private:
+		unsigned char _classes[256];
+
+		static constexpr unsigned char classify(int c) noexcept {
+			return (c == ' ' || c == '\t' ? blank : 0)
+				| (c == ' ' || (c >= '\t' && c <= '\r') ? space : 0)
+				| (c >= '0' && c <= '9' ? digit : 0)
+				| (c == '\n' || c == '\r' ? newline : 0);
+		}
+	};
+
+	constexpr classic_char_table classic_chars;
+
+	static_assert(classic_chars.is(classic_char_table::digit, '7')
+	              && !classic_chars.is(classic_char_table::digit, 'a')
+	              && classic_chars.is(classic_char_table::blank, '\t')
+	              && !classic_chars.is(classic_char_table::blank, '\n')
+	              && !classic_chars.is(classic_char_table::space, '\xa0'),
+	              "classic_chars disagrees with the classic locale");
+} // namespace calc
+
+#endif // CALC_CHAR_CLASS_HPP
@@ -15,6 +15,9 @@
 #if HAVE_UNISTD_H
 #include <unistd.h>
 #endif
+#if HAVE_GETOPT_H
+#include <getopt.h>
+#endif
 #include <iostream>
 
 #if defined(_WIN32) || defined(__CYGWIN__)
@@ -26,6 +29,48 @@
 namespace calc {
 	static std::string program_name;
 	static bool program_interactive;
+	static run_mode program_mode = run_mode::evaluate;
+	static const char* program_cache_path = nullptr;
+	static bool program_print_alloc_stats = false;
+	static bool program_print_stats = false;
+	static const char* program_trace_path = nullptr;
+	static bool program_utf8 = false;
+	static bool program_all_errors = false;
+	static bool program_share_subexpressions = false;
+	static bool program_batch = false;
+
+#if HAVE_GETOPT_H
+	/// Values returned by getopt_long() for options without a short name.
+	enum {
+		emit_llvm_option = 256,
+		emit_c_option,
+		compile_cache_option,
+		load_cache_option,
+		alloc_stats_option,
+		stats_option,
+		trace_option,
+		utf8_option,
+		all_errors_option,
+		cse_option,
+		batch_option
+	};
+
+	static const struct option long_options[] = {
+		{"interactive", no_argument, nullptr, 'i'},
+		{"emit-llvm", no_argument, nullptr, emit_llvm_option},
+		{"emit-c", no_argument, nullptr, emit_c_option},
+		{"compile-cache", required_argument, nullptr, compile_cache_option},
+		{"load-cache", required_argument, nullptr, load_cache_option},
+		{"alloc-stats", no_argument, nullptr, alloc_stats_option},
+		{"stats", no_argument, nullptr, stats_option},
+		{"trace", required_argument, nullptr, trace_option},
+		{"utf8", no_argument, nullptr, utf8_option},
+		{"all-errors", no_argument, nullptr, all_errors_option},
+		{"cse", no_argument, nullptr, cse_option},
+		{"batch", no_argument, nullptr, batch_option},
+		{nullptr, 0, nullptr, 0}
+	};
+#endif
 
 	static bool path_has_drive(const std::string& path) {
 		if (path.size() >= 2) {
@@ -88,11 +133,52 @@ namespace calc {
 		// process command-line arguments
 		int c;
 
+#if HAVE_GETOPT_H
+		while ((c = getopt_long(argc, argv, "i", long_options, nullptr)) != -1) {
+#else
 		while ((c = getopt(argc, argv, "i")) != -1) {
+#endif
 			switch (c) {
 				case 'i':
 					program_interactive = true;
 					break;
+#if HAVE_GETOPT_H
+				case emit_llvm_option:
+					program_mode = run_mode::emit_llvm;
+					break;
+				case emit_c_option:
+					program_mode = run_mode::emit_c;
+					break;
+				case compile_cache_option:
+					program_mode = run_mode::compile_cache;
+					program_cache_path = optarg;
+					break;
+				case load_cache_option:
+					program_mode = run_mode::load_cache;
+					program_cache_path = optarg;
+					break;
+				case alloc_stats_option:
+					program_print_alloc_stats = true;
+					break;
+				case stats_option:
+					program_print_stats = true;
+					break;
+				case trace_option:
+					program_trace_path = optarg;
+					break;
+				case utf8_option:
+					program_utf8 = true;
+					break;
+				case all_errors_option:
+					program_all_errors = true;
+					break;
+				case cse_option:
+					program_share_subexpressions = true;
+					break;
+				case batch_option:
+					program_batch = true;
+					break;
+#endif
 				case '?':
 					std::exit(2);
 				default:
@@ -106,6 +192,42 @@ namespace calc {
 		return program_interactive;
 	}
 
+	run_mode mode() {
+		return program_mode;
+	}
+
+	const char* cache_path() {
+		return program_cache_path;
+	}
+
+	bool print_alloc_stats() {
+		return program_print_alloc_stats;
+	}
+
+	bool print_stats() {
+		return program_print_stats;
+	}
+
+	const char* trace_path() {
+		return program_trace_path;
+	}
+
+	bool utf8() {
+		return program_utf8;
+	}
+
+	bool all_errors() {
+		return program_all_errors;
+	}
+
+	bool share_subexpressions() {
+		return program_share_subexpressions;
+	}
+
+	bool batch() {
+		return program_batch;
+	}
+
 	void show_prompt() {
 		std::cerr << "> ";
 	}
@@ -122,4 +244,6 @@ namespace calc {
 	// Explicit instantiations for the report_error function template.
 	template void report_error(const parse_error&);
 	template void report_error(const wparse_error&);
+	template void report_error(const parse_diagnostic&);
+	template void report_error(const wparse_diagnostic&);
 } // namespace calc
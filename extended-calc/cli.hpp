@@ -15,14 +15,35 @@
 #include "parse_error.hpp"
 
 namespace calc {
+	/// Identifies what the program does with each parsed expression.
+	enum class run_mode {
+		evaluate,
+		emit_llvm,
+		emit_c,
+		compile_cache,
+		load_cache
+	};
+
 	void init(const char* name);
 	void init(int argc, char* argv[]);
 	bool is_interactive();
+	run_mode mode();
+	const char* cache_path();
+	bool print_alloc_stats();
+	bool print_stats();
+	const char* trace_path();
+	bool utf8();
+	bool all_errors();
+	bool share_subexpressions();
+	bool batch();
 	void show_prompt();
 	void report_error(const char* format, ...);
 
 	template <typename CharT, class Traits>
 	void report_error(const basic_parse_error<CharT, Traits>& error);
+
+	template <typename CharT, class Traits>
+	void report_error(const basic_parse_diagnostic<CharT, Traits>& diagnostic);
 } // namespace calc
 
 #include "cli.ipp"
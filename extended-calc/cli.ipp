@@ -14,13 +14,24 @@
 namespace calc {
 	template <typename CharT, class Traits>
 	inline void report_error(const basic_parse_error<CharT, Traits>& error) {
-		report_error("syntax error: %s", error.what());
+		report_error("syntax error at line %zu, column %zu: %s",
+		             error.extent().start_line_number(),
+		             error.extent().start_column_number(), error.what());
+	}
+
+	template <typename CharT, class Traits>
+	inline void report_error(const basic_parse_diagnostic<CharT, Traits>& diagnostic) {
+		report_error("syntax error at line %zu, column %zu: %s",
+		             diagnostic.extent().start_line_number(),
+		             diagnostic.extent().start_column_number(), diagnostic.message());
 	}
 
 	// Inhibit implicit instantiations for required instantiations, which are
 	// defined via explicit instantiations elsewhere.
 	extern template void report_error(const parse_error&);
 	extern template void report_error(const wparse_error&);
+	extern template void report_error(const parse_diagnostic&);
+	extern template void report_error(const wparse_diagnostic&);
 } // namespace calc
 
 #endif // CALC_CLI_IPP
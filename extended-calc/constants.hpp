@@ -46,6 +46,30 @@ namespace calc {
 		right_parenthesis
 	};
 
+	/// The kinds of expression node in an abstract syntax tree.
+	enum class expr_kind : unsigned char {
+		positive,
+		negative,
+		addition,
+		subtraction,
+		multiplication,
+		division,
+		modulus,
+		equal,
+		not_equal,
+		less,
+		greater,
+		less_equal,
+		greater_equal,
+		logical_not,
+		logical_and,
+		logical_or,
+		boolean,
+		integer,
+		error,
+		big_integer
+	};
+
 	/// Flags that specify additional information about a given token.
 	enum class token_flags : unsigned int {
 		none = 0,
@@ -0,0 +1,16 @@
+/**
+ * @file		document.cpp
+ * Contains type definitions for editable scripts.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#include "document.hpp"
+
+namespace calc {
+	// Explicit instantiations for the basic_document class template.
+	template class basic_document<char>;
+	template class basic_document<wchar_t>;
+} // namespace calc
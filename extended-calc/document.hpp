@@ -0,0 +1,187 @@
+/**
+ * @file		document.hpp
+ * Contains type declarations for editable scripts.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_DOCUMENT_HPP
+#define CALC_DOCUMENT_HPP
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "parse_context.hpp"
+
+namespace calc {
+	template <typename CharT, class Traits = symbol_traits<CharT>>
+	class basic_document;
+
+	/// A document of @c char characters.
+	typedef basic_document<char> document;
+
+	/// A document of @c wchar_t characters.
+	typedef basic_document<wchar_t> wdocument;
+
+	/**
+	 * A script that is edited in place, as in an editor, and kept parsed.
+	 * Since every line is an independent expression, a document keeps the
+	 * text, abstract syntax tree, and diagnostics of each line apart, and
+	 * an edit only re-lexes and re-parses the lines that it touches.
+	 * Positions are kept per line, so the lines after an edit need no
+	 * update either. Lines are parsed in recovery mode, so each one has
+	 * all of its diagnostics. Column numbers count characters, or code
+	 * points in UTF-8 mode, as in a basic_script_position. Lines end where
+	 * the lexer's newlines do, at a line feed, a carriage return, or a
+	 * carriage return and line feed, and each line keeps its newline.
+	 * @tparam CharT	The character type.
+	 * @tparam Traits	The symbol traits type.
+	 */
+	template <typename CharT, class Traits>
+	class basic_document {
+	public:
+		typedef CharT char_type;
+		typedef Traits traits_type;
+		typedef typename Traits::string_type string_type;
+		typedef typename Traits::string_view_type string_view_type;
+
+		/// A syntax error in a line of a document.
+		struct diagnostic {
+			error_id code;
+			/// The column number of the first character in error.
+			std::size_t start_column_number;
+			/// The column number after the last character in error.
+			std::size_t end_column_number;
+			const char* message;
+		};
+
+		/**
+		 * Constructs a document that holds @p text.
+		 * @param text	The initial text of the document.
+		 */
+		explicit basic_document(string_view_type text = string_view_type());
+
+		basic_document(const basic_document&) = delete;
+
+		basic_document& operator=(const basic_document&) = delete;
+
+		/**
+		 * Replaces the text from one position to another with @p text, and
+		 * re-parses the lines that result. Line and column numbers start
+		 * at 1, as in a basic_script_position; a column number may be one
+		 * past the end of its line. An edit that adds or removes lines
+		 * moves the pointers to all of the lines after it, which takes
+		 * time linear in their number, although none of them is copied or
+		 * re-parsed.
+		 * @param start_line	The line number of the start of the edit.
+		 * @param start_column	The column number of the start of the edit.
+		 * @param end_line		The line number of the end of the edit.
+		 * @param end_column	The column number of the end of the edit,
+		 * 						which is not replaced.
+		 * @param text			The replacement text, which may contain
+		 * 						newlines.
+		 * @throw std::out_of_range	If a position is outside of the document
+		 * 							or the end is before the start.
+		 */
+		void edit(std::size_t start_line, std::size_t start_column,
+		          std::size_t end_line, std::size_t end_column,
+		          string_view_type text);
+
+		/**
+		 * Returns whether the text is treated as UTF-8.
+		 * @return	@c true if the text is treated as UTF-8.
+		 */
+		bool utf8() const noexcept {
+			return this->_context.parser().utf8();
+		}
+
+		/**
+		 * Turns UTF-8 mode on or off, and re-parses every line, since the
+		 * columns of their diagnostics change.
+		 * @param enable	Whether to treat the text as UTF-8.
+		 */
+		void utf8(bool enable);
+
+		/**
+		 * Returns the number of lines, which is one more than the number of
+		 * newlines.
+		 * @return	The number of lines.
+		 */
+		std::size_t line_count() const noexcept {
+			return this->_lines.size();
+		}
+
+		/**
+		 * Returns the text of a line, without its newline.
+		 * @param line_number	A line number.
+		 * @return				The text of the line.
+		 */
+		string_view_type line(std::size_t line_number) const {
+			return this->entry(line_number).text;
+		}
+
+		/**
+		 * Returns the abstract syntax tree of a line, which may contain
+		 * error_expr nodes.
+		 * @param line_number	A line number.
+		 * @return				The abstract syntax tree of the line, or null
+		 * 						if the line is empty.
+		 */
+		const expr* tree(std::size_t line_number) const {
+			return this->entry(line_number).tree.get();
+		}
+
+		/**
+		 * Returns the syntax errors of a line.
+		 * @param line_number	A line number.
+		 * @return				The diagnostics of the line, in order.
+		 */
+		const std::vector<diagnostic>& diagnostics(std::size_t line_number) const {
+			return this->entry(line_number).diagnostics;
+		}
+
+		/**
+		 * Returns the number of lines that the last edit parsed.
+		 * @return	The number of lines parsed by the last edit.
+		 */
+		std::size_t parsed_line_count() const noexcept {
+			return this->_parsed_line_count;
+		}
+
+		/**
+		 * Returns the whole text of the document.
+		 * @return	The text of the document.
+		 */
+		string_type text() const;
+
+	private:
+		struct line_entry {
+			string_type text;
+			/// The newline that ends the line, which is empty for the last
+			/// line.
+			string_type newline;
+			std::unique_ptr<const expr> tree;
+			std::vector<diagnostic> diagnostics;
+		};
+
+		/// The lines, by pointer so that an edit that adds or removes lines
+		/// moves as little as possible.
+		std::vector<std::unique_ptr<line_entry>> _lines;
+		basic_parse_context<CharT, Traits> _context;
+		std::size_t _parsed_line_count;
+
+		const line_entry& entry(std::size_t line_number) const;
+		std::vector<std::unique_ptr<line_entry>> split(string_view_type text);
+		void parse(line_entry& line);
+		std::size_t offset(string_view_type line, std::size_t column_number) const;
+	};
+} // namespace calc
+
+#include "document.ipp"
+
+#endif // CALC_DOCUMENT_HPP
@@ -0,0 +1,182 @@
+/**
+ * @file		document.ipp
+ * Contains template definitions and explicit template instantiation
+ * declarations.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_DOCUMENT_IPP
+#define CALC_DOCUMENT_IPP
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace calc {
+	template <typename CharT, class Traits>
+	basic_document<CharT, Traits>::basic_document(string_view_type text) :
+		_lines(), _context(), _parsed_line_count(0)
+	{
+		this->_context.parser().recover(true);
+		this->_lines = this->split(text);
+	}
+
+	template <typename CharT, class Traits>
+	void
+	basic_document<CharT, Traits>::edit(std::size_t start_line, std::size_t start_column,
+	                                    std::size_t end_line, std::size_t end_column,
+	                                    string_view_type text)
+	{
+		if (start_line < 1 || end_line > this->line_count() || start_line > end_line)
+			throw std::out_of_range("calc::basic_document::edit");
+		const std::size_t start_offset = this->offset(this->line(start_line), start_column);
+		const std::size_t end_offset = this->offset(this->line(end_line), end_column);
+		if (start_offset == string_view_type::npos || end_offset == string_view_type::npos
+		    || (start_line == end_line && start_offset > end_offset))
+			throw std::out_of_range("calc::basic_document::edit");
+
+		// the edited lines become one piece of text, which is split again;
+		// it takes in the line before them if that ends in a carriage
+		// return, which the edit may make the start of a CR LF, and the
+		// newline of the last line, which the edit may make the end of one
+		std::size_t first_line = start_line;
+		string_type joined;
+		if (start_offset == 0 && start_line > 1) {
+			const line_entry& previous = *this->_lines[start_line - 2];
+			if (previous.newline.size() == 1 && Traits::eq(previous.newline[0], CharT('\r'))) {
+				first_line--;
+				joined = previous.text + previous.newline;
+			}
+		}
+		const string_view_type start_text = this->line(start_line).substr(0, start_offset);
+		joined.append(start_text.data(), start_text.size());
+		joined.append(text.data(), text.size());
+		const string_view_type end_text = this->line(end_line).substr(end_offset);
+		joined.append(end_text.data(), end_text.size());
+		joined.append(this->_lines[end_line - 1]->newline);
+
+		std::vector<std::unique_ptr<line_entry>> lines = this->split(joined);
+		// the empty line after a newline of the last line is not part of
+		// the edit
+		if (!this->_lines[end_line - 1]->newline.empty()) {
+			lines.pop_back();
+			this->_parsed_line_count--;
+		}
+		const std::size_t old_count = end_line - first_line + 1;
+		const std::size_t common_count = std::min(old_count, lines.size());
+
+		auto position = this->_lines.begin() + (first_line - 1);
+		std::move(lines.begin(), lines.begin() + common_count, position);
+		position += common_count;
+		if (lines.size() > old_count)
+			this->_lines.insert(position, std::make_move_iterator(lines.begin() + common_count),
+			                    std::make_move_iterator(lines.end()));
+		else
+			this->_lines.erase(position, position + (old_count - common_count));
+	}
+
+	template <typename CharT, class Traits>
+	void
+	basic_document<CharT, Traits>::utf8(bool enable) {
+		this->_context.parser().utf8(enable);
+		for (const std::unique_ptr<line_entry>& line : this->_lines)
+			this->parse(*line);
+		this->_parsed_line_count = this->_lines.size();
+	}
+
+	template <typename CharT, class Traits>
+	typename basic_document<CharT, Traits>::string_type
+	basic_document<CharT, Traits>::text() const {
+		string_type result;
+		for (const std::unique_ptr<line_entry>& line : this->_lines) {
+			result.append(line->text);
+			result.append(line->newline);
+		}
+		return result;
+	}
+
+	template <typename CharT, class Traits>
+	const typename basic_document<CharT, Traits>::line_entry&
+	basic_document<CharT, Traits>::entry(std::size_t line_number) const {
+		if (line_number < 1 || line_number > this->line_count())
+			throw std::out_of_range("calc::basic_document::entry");
+		return *this->_lines[line_number - 1];
+	}
+
+	template <typename CharT, class Traits>
+	std::vector<std::unique_ptr<typename basic_document<CharT, Traits>::line_entry>>
+	basic_document<CharT, Traits>::split(string_view_type text) {
+		std::vector<std::unique_ptr<line_entry>> lines;
+		std::size_t start = 0;
+
+		// lines end where the lexer's newlines do: at a line feed, a
+		// carriage return, or both in that order
+		const CharT newlines[] = {CharT('\r'), CharT('\n')};
+		while (true) {
+			const std::size_t end = text.find_first_of(newlines, start, 2);
+			lines.push_back(std::make_unique<line_entry>());
+			lines.back()->text = text.substr(start, end - start).to_string();
+			this->parse(*lines.back());
+			if (end == string_view_type::npos)
+				break;
+			start = end + 1;
+			if (Traits::eq(text[end], CharT('\r')) && start < text.size()
+			    && Traits::eq(text[start], CharT('\n')))
+				start++;
+			lines.back()->newline = text.substr(end, start - end).to_string();
+		}
+
+		this->_parsed_line_count = lines.size();
+		return lines;
+	}
+
+	template <typename CharT, class Traits>
+	void
+	basic_document<CharT, Traits>::parse(line_entry& line) {
+		typedef typename basic_parser<CharT, Traits>::result_type result_type;
+
+		this->_context.reset(line.text);
+		result_type result = this->_context.parser().try_next_expr(true);
+		line.tree = result ? std::move(result.value()) : nullptr;
+
+		// the diagnostics belong to the parser, which forgets them on reset;
+		// their columns are resolved through their extents, which count
+		// code points in UTF-8 mode
+		line.diagnostics.clear();
+		for (const auto* d : this->_context.parser().last_errors())
+			line.diagnostics.push_back({d->code(),
+			                            d->extent().start_column_number(),
+			                            d->extent().end_column_number(),
+			                            d->message()});
+	}
+
+	template <typename CharT, class Traits>
+	std::size_t
+	basic_document<CharT, Traits>::offset(string_view_type line, std::size_t column_number) const {
+		if (column_number < 1)
+			return string_view_type::npos;
+		if (!this->utf8())
+			return column_number - 1 <= line.size() ? column_number - 1 : string_view_type::npos;
+
+		// skip a code point per column: a byte and the bytes that continue it
+		std::size_t offset = 0;
+		for (std::size_t i = 1; i < column_number; i++) {
+			if (offset == line.size())
+				return string_view_type::npos;
+			do
+				offset++;
+			while (offset < line.size() && (static_cast<unsigned char>(line[offset]) & 0xc0) == 0x80);
+		}
+		return offset;
+	}
+
+	// Inhibit implicit instantiations for required instantiations, which are
+	// defined via explicit instantiations elsewhere.
+	extern template class basic_document<char>;
+	extern template class basic_document<wchar_t>;
+} // namespace calc
+
+#endif // CALC_DOCUMENT_IPP
@@ -0,0 +1,299 @@
+/**
+ * @file		expr_dag.cpp
+ * Contains type definitions for hash-consed expression graphs.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#include "expr_dag.hpp"
+
+#include <stdexcept>
+
+namespace calc {
+	static std::size_t hash_node(expr_kind kind, integer_t data,
+	                             expr_dag::node_id left, expr_dag::node_id right) noexcept
+	{
+		typedef default_integer_policy::unsigned_type unsigned_type;
+		const unsigned_type bits = static_cast<unsigned_type>(data);
+		// the high half of a 128-bit literal
+		const std::uint64_t high = static_cast<std::uint64_t>(bits >> (sizeof(bits) > 8 ? 64 : 0));
+		std::uint64_t hash = (static_cast<std::uint64_t>(left) << 32 | right)
+			^ (static_cast<std::uint64_t>(bits) << 8 ^ (sizeof(bits) > 8 ? high : 0)
+			   ^ static_cast<std::uint64_t>(kind)) * 0x9e3779b97f4a7c15ULL;
+		// the finalizer of MurmurHash3, so that every bit of the key affects
+		// the low bits that pick a bucket
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdULL;
+		hash ^= hash >> 33;
+		hash *= 0xc4ceb9fe1a85ec53ULL;
+		hash ^= hash >> 33;
+		return static_cast<std::size_t>(hash);
+	}
+
+	/**
+	 * Interns the nodes of an expression in postfix order.
+	 */
+	class expr_dag::builder : public expr_visitor {
+	public:
+		explicit builder(expr_dag& dag) :
+			_dag(dag), _id(0)
+		{}
+
+		node_id build(const expr& e) {
+			e.accept(*this);
+			this->_dag._added_node_count++;
+			return this->_id;
+		}
+
+		void visit(const positive_expr& e) { this->unary(e); }
+		void visit(const negative_expr& e) { this->unary(e); }
+		void visit(const addition_expr& e) { this->binary(e); }
+		void visit(const subtraction_expr& e) { this->binary(e); }
+		void visit(const multiplication_expr& e) { this->binary(e); }
+		void visit(const division_expr& e) { this->binary(e); }
+		void visit(const modulus_expr& e) { this->binary(e); }
+		void visit(const equal_expr& e) { this->binary(e); }
+		void visit(const not_equal_expr& e) { this->binary(e); }
+		void visit(const less_expr& e) { this->binary(e); }
+		void visit(const greater_expr& e) { this->binary(e); }
+		void visit(const less_equal_expr& e) { this->binary(e); }
+		void visit(const greater_equal_expr& e) { this->binary(e); }
+		void visit(const logical_not_expr& e) { this->unary(e); }
+		void visit(const logical_and_expr& e) { this->binary(e); }
+		void visit(const logical_or_expr& e) { this->binary(e); }
+
+		void visit(const boolean& e) {
+			this->_id = this->_dag.intern(e.kind(), e.to_bool(), 0, 0);
+		}
+
+		void visit(const integer& e) {
+			this->_id = this->_dag.intern(e.kind(), e.to_integer(), 0, 0);
+		}
+
+		void visit(const error_expr& e) {
+			throw std::invalid_argument("calc::expr_dag::add");
+		}
+
+		void visit(const big_integer& e) {
+			// the nodes hold integer_t
+			throw std::overflow_error("calc::expr_dag::add");
+		}
+
+	private:
+		expr_dag& _dag;
+		node_id _id;
+
+		void unary(const unary_expr& e) {
+			const node_id operand = this->build(*e.operand());
+			this->_id = this->_dag.intern(e.kind(), 0, operand, 0);
+		}
+
+		void binary(const binary_expr& e) {
+			const node_id left = this->build(*e.left_operand());
+			const node_id right = this->build(*e.right_operand());
+			this->_id = this->_dag.intern(e.kind(), 0, left, right);
+		}
+	};
+
+	const expr_dag::node_id expr_dag::no_node;
+
+	expr_dag::expr_dag() :
+		_nodes(), _buckets(64, no_node), _added_node_count(0)
+	{}
+
+	expr_dag::node_id expr_dag::add(const expr& e) {
+		builder b(*this);
+		return b.build(e);
+	}
+
+	expr_dag::node_id expr_dag::intern(expr_kind kind, integer_t data,
+	                                   node_id left, node_id right)
+	{
+		const std::size_t mask = this->_buckets.size() - 1;
+		std::size_t i = hash_node(kind, data, left, right) & mask;
+
+		for (; this->_buckets[i] != no_node; i = (i + 1) & mask) {
+			const node& n = this->_nodes[this->_buckets[i]];
+			if (n.kind == kind && n.data == data && n.left == left && n.right == right)
+				return this->_buckets[i];
+		}
+
+		if (this->_nodes.size() >= no_node)
+			throw std::length_error("calc::expr_dag::add");
+
+		const node_id id = static_cast<node_id>(this->_nodes.size());
+		this->_nodes.push_back({kind, result_state::unevaluated, data, left, right, 0});
+		this->_buckets[i] = id;
+
+		// keep the table at most half full
+		if (this->_nodes.size() * 2 > this->_buckets.size())
+			this->rehash();
+		return id;
+	}
+
+	void expr_dag::rehash() {
+		std::vector<node_id> buckets(this->_buckets.size() * 2, no_node);
+		const std::size_t mask = buckets.size() - 1;
+
+		for (node_id id = 0; id < this->_nodes.size(); id++) {
+			const node& n = this->_nodes[id];
+			std::size_t i = hash_node(n.kind, n.data, n.left, n.right) & mask;
+			while (buckets[i] != no_node)
+				i = (i + 1) & mask;
+			buckets[i] = id;
+		}
+
+		this->_buckets.swap(buckets);
+	}
+
+	bool expr_dag::is_error(result_state state) noexcept {
+		return state == result_state::invalid_argument
+		       || state == result_state::domain_error
+		       || state == result_state::overflow_error;
+	}
+
+	const expr_dag::node& expr_dag::evaluate(node_id id) const {
+		const node& n = this->_nodes[id];
+		if (n.state != result_state::unevaluated)
+			return n;
+
+		switch (n.kind) {
+			case expr_kind::boolean:
+				n.state = result_state::boolean;
+				n.result = n.data;
+				return n;
+			case expr_kind::integer:
+				n.state = result_state::integer;
+				n.result = n.data;
+				return n;
+			case expr_kind::positive:
+			case expr_kind::negative:
+			case expr_kind::logical_not: {
+				// as in the tree, an error in an operand is the error of the
+				// whole expression
+				const node& operand = this->evaluate(n.left);
+				const result_state operand_type = n.kind == expr_kind::logical_not
+					? result_state::boolean : result_state::integer;
+				if (operand.state != operand_type) {
+					n.state = is_error(operand.state) ? operand.state : result_state::invalid_argument;
+					return n;
+				}
+				n.state = operand_type;
+				if (n.kind == expr_kind::negative) {
+					if (default_integer_policy::negate(operand.result, n.result))
+						n.state = result_state::overflow_error;
+				}
+				else
+					n.result = n.kind == expr_kind::logical_not ? !operand.result : operand.result;
+				return n;
+			}
+			default:
+				break;
+		}
+
+		// the left operand is evaluated first, so its error comes first
+		const node& left = this->evaluate(n.left);
+		if (is_error(left.state)) {
+			n.state = left.state;
+			return n;
+		}
+		const node& right = this->evaluate(n.right);
+		if (is_error(right.state)) {
+			n.state = right.state;
+			return n;
+		}
+
+		switch (n.kind) {
+			case expr_kind::equal:
+			case expr_kind::not_equal:
+				if (left.state != right.state) {
+					n.state = result_state::invalid_argument;
+					return n;
+				}
+				n.state = result_state::boolean;
+				n.result = (left.result == right.result) == (n.kind == expr_kind::equal);
+				return n;
+			case expr_kind::logical_and:
+			case expr_kind::logical_or:
+				if (left.state != result_state::boolean || right.state != result_state::boolean) {
+					n.state = result_state::invalid_argument;
+					return n;
+				}
+				n.state = result_state::boolean;
+				n.result = n.kind == expr_kind::logical_and ? left.result && right.result
+				                                            : left.result || right.result;
+				return n;
+			default:
+				break;
+		}
+
+		if (left.state != result_state::integer || right.state != result_state::integer) {
+			n.state = result_state::invalid_argument;
+			return n;
+		}
+
+		n.state = result_state::integer;
+		bool overflow = false;
+		switch (n.kind) {
+			case expr_kind::addition:
+				overflow = default_integer_policy::add(left.result, right.result, n.result);
+				break;
+			case expr_kind::subtraction:
+				overflow = default_integer_policy::subtract(left.result, right.result, n.result);
+				break;
+			case expr_kind::multiplication:
+				overflow = default_integer_policy::multiply(left.result, right.result, n.result);
+				break;
+			case expr_kind::division:
+			case expr_kind::modulus:
+				if (right.result == 0)
+					n.state = result_state::domain_error;
+				else if (n.kind == expr_kind::division)
+					overflow = default_integer_policy::divide(left.result, right.result, n.result);
+				else
+					overflow = default_integer_policy::modulo(left.result, right.result, n.result);
+				break;
+			case expr_kind::less:
+				n.state = result_state::boolean;
+				n.result = left.result < right.result;
+				break;
+			case expr_kind::greater:
+				n.state = result_state::boolean;
+				n.result = left.result > right.result;
+				break;
+			case expr_kind::less_equal:
+				n.state = result_state::boolean;
+				n.result = left.result <= right.result;
+				break;
+			case expr_kind::greater_equal:
+				n.state = result_state::boolean;
+				n.result = left.result >= right.result;
+				break;
+			default:
+				n.state = result_state::invalid_argument;
+				break;
+		}
+		if (overflow)
+			n.state = result_state::overflow_error;
+		return n;
+	}
+
+	std::unique_ptr<class value> expr_dag::value(node_id id) const {
+		const node& n = this->evaluate(id);
+
+		switch (n.state) {
+			case result_state::boolean:
+				return std::make_unique<boolean_value>(n.result != 0);
+			case result_state::integer:
+				return std::make_unique<integer_value>(n.result);
+			case result_state::domain_error:
+				throw std::domain_error("calc::expr_dag::value");
+			case result_state::overflow_error:
+				throw std::overflow_error("calc::expr_dag::value");
+			default:
+				throw std::invalid_argument("calc::expr_dag::value");
+		}
+	}
+} // namespace calc
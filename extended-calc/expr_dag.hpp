@@ -0,0 +1,129 @@
+/**
+ * @file		expr_dag.hpp
+ * Contains type declarations for hash-consed expression graphs.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_EXPR_DAG_HPP
+#define CALC_EXPR_DAG_HPP
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ast.hpp"
+
+namespace calc {
+	/**
+	 * Stores many expressions as one directed acyclic graph in which
+	 * structurally identical subexpressions, within an expression or across
+	 * expressions, are a single node. Nodes are found by a hash of their
+	 * kind, literal value, and operand nodes, so adding a tree takes time
+	 * linear in its size. The value of each node is computed at most once,
+	 * and remembered along with any error, so a subexpression shared by
+	 * many expressions is evaluated once for all of them.
+	 */
+	class expr_dag {
+	public:
+		/// Identifies a node. The operands of a node precede it.
+		typedef std::uint32_t node_id;
+
+		expr_dag();
+
+		expr_dag(const expr_dag&) = delete;
+
+		expr_dag& operator=(const expr_dag&) = delete;
+
+		/**
+		 * Adds the nodes of an expression that are not in the graph yet.
+		 * The tree is not referenced afterwards.
+		 * @param e		An expression.
+		 * @return		The node of @p e.
+		 * @throw std::invalid_argument	If @p e contains an error_expr.
+		 * @throw std::overflow_error	If @p e contains a big_integer.
+		 * @throw std::length_error		If the graph would have more nodes
+		 * 								than a node_id can identify.
+		 */
+		node_id add(const expr& e);
+
+		/**
+		 * Evaluates a node, or returns its remembered value.
+		 * @param id	A node returned by add().
+		 * @return		The value of the node.
+		 * @throw std::invalid_argument	If the operands of an operator have
+		 * 								the wrong types.
+		 * @throw std::domain_error		If the node divides by zero.
+		 * @throw std::overflow_error	If a checked integer operation
+		 * 								overflows.
+		 */
+		std::unique_ptr<class value> value(node_id id) const;
+
+		/**
+		 * Returns the number of distinct nodes.
+		 * @return	The number of nodes in the graph.
+		 */
+		std::size_t size() const noexcept {
+			return this->_nodes.size();
+		}
+
+		/**
+		 * Returns the number of nodes of every tree passed to add(), which
+		 * is how many nodes the trees would have taken without sharing.
+		 * @return	The number of nodes added.
+		 */
+		std::size_t added_node_count() const noexcept {
+			return this->_added_node_count;
+		}
+
+		expr_kind kind(node_id id) const noexcept {
+			return this->_nodes[id].kind;
+		}
+
+	private:
+		class builder;
+
+		/// The memoized result of a node.
+		enum class result_state : std::uint8_t {
+			unevaluated,
+			boolean,
+			integer,
+			invalid_argument,
+			domain_error,
+			overflow_error
+		};
+
+		struct node {
+			expr_kind kind;
+			mutable result_state state;
+			/// The value of a literal; zero otherwise.
+			integer_t data;
+			/// The operand of a unary node or the left operand of a binary
+			/// node; zero otherwise.
+			node_id left;
+			/// The right operand of a binary node; zero otherwise.
+			node_id right;
+			mutable integer_t result;
+		};
+
+		/// Marks an empty bucket.
+		static const node_id no_node = UINT32_MAX;
+
+		std::vector<node> _nodes;
+		/// An open-addressing table of node ids, with linear probing.
+		std::vector<node_id> _buckets;
+		std::size_t _added_node_count;
+
+		node_id intern(expr_kind kind, integer_t data, node_id left, node_id right);
+		void rehash();
+		static bool is_error(result_state state) noexcept;
+		const node& evaluate(node_id id) const;
+	};
+} // namespace calc
+
+#endif // CALC_EXPR_DAG_HPP
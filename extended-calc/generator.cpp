@@ -0,0 +1,340 @@
+/**
+ * @file		generator.cpp
+ * Contains type definitions for generating random scripts.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#include "generator.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace calc {
+	namespace {
+		/*
+		 * The precedence levels of the grammar, from the most to the least
+		 * tightly binding. An operand whose level is greater than the level
+		 * allowed by its context is enclosed in parentheses.
+		 */
+		enum level : int {
+			primary_level,
+			unary_level,
+			multiplicative_level,
+			additive_level,
+			ordering_level,
+			equality_level,
+			logical_and_level,
+			logical_or_level
+		};
+
+		/// The maximum number of digits in an integer literal.
+		const unsigned int max_literal_digits = 10;
+
+		/// Returns the index of the alternative chosen by a weighted draw.
+		template <std::size_t N>
+		std::size_t weighted_choice(const unsigned int (&weights)[N],
+		                            unsigned int draw)
+		{
+			for (std::size_t i = 0; i < N; i++) {
+				if (draw < weights[i])
+					return i;
+				draw -= weights[i];
+			}
+			return N - 1;
+		}
+
+		/// Returns the value below which a uniform 64-bit draw has
+		/// probability @p p.
+		std::uint64_t threshold(double p) {
+			if (p <= 0.0)
+				return 0;
+			if (p >= 1.0)
+				return UINT64_MAX;
+			return static_cast<std::uint64_t>(p * 18446744073709551616.0);
+		}
+	} // namespace
+
+	bool operator_mix::parse(const std::string& spec) {
+		std::size_t begin = 0;
+		while (begin < spec.size()) {
+			std::size_t end = spec.find(',', begin);
+			if (end == std::string::npos)
+				end = spec.size();
+
+			const std::string entry = spec.substr(begin, end - begin);
+			const std::size_t colon = entry.find(':');
+			if (colon == std::string::npos)
+				return false;
+
+			const std::string name = entry.substr(0, colon);
+			const std::string weight = entry.substr(colon + 1);
+			char* weight_end = nullptr;
+			const unsigned long n = std::strtoul(weight.c_str(), &weight_end, 10);
+			if (weight.empty() || *weight_end != '\0' || n > 1000000)
+				return false;
+
+			if (name == "additive")
+				this->additive = n;
+			else if (name == "multiplicative")
+				this->multiplicative = n;
+			else if (name == "unary")
+				this->unary = n;
+			else if (name == "ordering")
+				this->ordering = n;
+			else if (name == "equality")
+				this->equality = n;
+			else if (name == "logical")
+				this->logical = n;
+			else
+				return false;
+
+			begin = end + 1;
+		}
+		return true;
+	}
+
+	expr_generator::expr_generator(const generator_options& options) :
+		_options(options), _state(options.seed),
+		_blank_threshold(threshold(options.whitespace_density)),
+		_tab_threshold(threshold(options.whitespace_density
+		                         * options.whitespace_density / 8))
+	{
+		this->_options.max_width = std::max(this->_options.max_width, 2u);
+		this->_options.max_digits = std::min(
+			std::max(this->_options.max_digits, 1u), max_literal_digits);
+	}
+
+	void expr_generator::generate_line(std::string& out) {
+		const std::size_t begin = out.size();
+		const unsigned int depth = this->_options.max_depth;
+
+		if (this->bernoulli(this->_options.boolean_ratio))
+			this->boolean_expr(out, depth, logical_or_level);
+		else
+			this->integer_expr(out, depth, logical_or_level);
+
+		if (this->_options.error_rate > 0.0
+		    && this->bernoulli(this->_options.error_rate))
+		{
+			// keep the line intact up to the error so that its position varies
+			std::string line = out.substr(begin);
+			out.resize(begin);
+			if (this->uniform(2) == 0) {
+				out += line;
+				this->inject_error(out);
+			} else {
+				this->inject_error(out);
+				out += line;
+			}
+		}
+
+		out += '\n';
+	}
+
+	std::uint64_t expr_generator::next() noexcept {
+		// splitmix64, chosen over the standard engines and distributions so
+		// that the output is identical on every platform
+		std::uint64_t z = (this->_state += 0x9e3779b97f4a7c15);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+		return z ^ (z >> 31);
+	}
+
+	unsigned int expr_generator::uniform(unsigned int n) noexcept {
+		return static_cast<unsigned int>(((this->next() >> 32) * n) >> 32);
+	}
+
+	bool expr_generator::bernoulli(double p) noexcept {
+		return static_cast<double>(this->next() >> 11) / 9007199254740992.0 < p;
+	}
+
+	void expr_generator::blank(std::string& out) {
+		// a single draw decides both the blank and the occasional tab
+		const std::uint64_t r = this->next();
+		if (r < this->_blank_threshold) {
+			out += ' ';
+			if (r < this->_tab_threshold)
+				out += '\t';
+		}
+	}
+
+	void expr_generator::token(std::string& out, const char* text) {
+		if (!out.empty() && out.back() != '\n')
+			this->blank(out);
+		out += text;
+	}
+
+	void expr_generator::literal(std::string& out, bool nonzero) {
+		static const std::uint32_t powers_of_ten[] = {
+			1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+			1000000000
+		};
+
+		if (!out.empty() && out.back() != '\n')
+			this->blank(out);
+
+		// draw the whole literal at once rather than digit by digit
+		const unsigned int digits = 1 + this->uniform(this->_options.max_digits);
+		const std::uint32_t low = digits == 1 ? (nonzero ? 1 : 0)
+		                                      : powers_of_ten[digits - 1];
+		// stay within the range of a 32-bit integer literal
+		const std::uint32_t high = digits == max_literal_digits
+		                           ? 2147483647u
+		                           : powers_of_ten[digits] - 1;
+		std::uint32_t n = low + this->uniform(high - low + 1);
+
+		char buffer[max_literal_digits];
+		char* first = buffer + max_literal_digits;
+		do {
+			*--first = static_cast<char>('0' + n % 10);
+			n /= 10;
+		} while (n != 0);
+		out.append(first, buffer + max_literal_digits);
+	}
+
+	void expr_generator::integer_expr(std::string& out, unsigned int depth,
+	                                  int max_level)
+	{
+		enum production { unary, multiplicative, additive };
+		const operator_mix& mix = this->_options.mix;
+		const unsigned int weights[] = {
+			mix.unary, mix.multiplicative, mix.additive
+		};
+		const unsigned int total = mix.unary + mix.multiplicative + mix.additive;
+
+		// the top level of a line is never a bare literal
+		if (depth == 0 || total == 0 || (max_level != logical_or_level
+		                                 && this->uniform(4) == 0))
+		{
+			this->literal(out);
+			return;
+		}
+
+		const std::size_t p = weighted_choice(weights, this->uniform(total));
+		const int level = p == unary ? unary_level
+		                : p == multiplicative ? multiplicative_level
+		                : additive_level;
+		const bool parenthesize = level > max_level;
+		if (parenthesize)
+			this->token(out, "(");
+
+		if (p == unary) {
+			this->token(out, this->uniform(4) == 0 ? "+" : "-");
+			this->integer_expr(out, depth - 1, unary_level);
+		} else {
+			static const char* const multiplicative_operators[] = {
+				"*", "*", "/", "%"
+			};
+			static const char* const additive_operators[] = {"+", "-"};
+			const unsigned int width = 2 + this->uniform(this->_options.max_width - 1);
+
+			for (unsigned int i = 0; i < width; i++) {
+				const char* op = nullptr;
+				if (i > 0) {
+					op = p == multiplicative
+					     ? multiplicative_operators[this->uniform(4)]
+					     : additive_operators[this->uniform(2)];
+					this->token(out, op);
+				}
+				// a literal divisor keeps most lines from dividing by zero
+				if (op && (op[0] == '/' || op[0] == '%'))
+					this->literal(out, true);
+				else
+					this->integer_expr(out, depth - 1, level - 1);
+			}
+		}
+
+		if (parenthesize)
+			this->token(out, ")");
+	}
+
+	void expr_generator::boolean_expr(std::string& out, unsigned int depth,
+	                                  int max_level)
+	{
+		enum production { logical_not, ordering, equality, logical };
+		const operator_mix& mix = this->_options.mix;
+		const unsigned int weights[] = {
+			mix.unary, mix.ordering, mix.equality, mix.logical
+		};
+		const unsigned int total = mix.unary + mix.ordering + mix.equality
+		                           + mix.logical;
+
+		if (depth == 0 || total == 0 || (max_level != logical_or_level
+		                                 && this->uniform(4) == 0))
+		{
+			this->token(out, this->uniform(2) == 0 ? "true" : "false");
+			return;
+		}
+
+		const std::size_t p = weighted_choice(weights, this->uniform(total));
+		const bool is_or = p == logical && this->uniform(2) == 0;
+		const int level = p == logical_not ? unary_level
+		                : p == ordering ? ordering_level
+		                : p == equality ? equality_level
+		                : is_or ? logical_or_level
+		                : logical_and_level;
+		const bool parenthesize = level > max_level;
+		if (parenthesize)
+			this->token(out, "(");
+
+		if (p == logical_not) {
+			this->token(out, "!");
+			this->boolean_expr(out, depth - 1, unary_level);
+		} else if (p == ordering) {
+			// comparisons do not chain, since a < b < c compares a boolean
+			// with an integer
+			static const char* const operators[] = {"<", ">", "<=", ">="};
+			this->integer_expr(out, depth - 1, level - 1);
+			this->token(out, operators[this->uniform(4)]);
+			this->integer_expr(out, depth - 1, level - 1);
+		} else if (p == equality) {
+			const bool is_boolean = this->bernoulli(this->_options.boolean_ratio);
+			auto operand = is_boolean ? &expr_generator::boolean_expr
+			                          : &expr_generator::integer_expr;
+			(this->*operand)(out, depth - 1, level - 1);
+			this->token(out, this->uniform(2) == 0 ? "==" : "!=");
+			(this->*operand)(out, depth - 1, level - 1);
+		} else {
+			const unsigned int width = 2 + this->uniform(this->_options.max_width - 1);
+			for (unsigned int i = 0; i < width; i++) {
+				if (i > 0)
+					this->token(out, is_or ? "||" : "&&");
+				this->boolean_expr(out, depth - 1, level - 1);
+			}
+		}
+
+		if (parenthesize)
+			this->token(out, ")");
+	}
+
+	void expr_generator::inject_error(std::string& out) {
+		switch (this->uniform(5)) {
+		case 0:
+			// unknown token
+			this->token(out, "$");
+			break;
+		case 1:
+			// unbalanced parenthesis
+			this->token(out, this->uniform(2) == 0 ? "(" : ")");
+			break;
+		case 2:
+			// missing operand
+			this->token(out, "*");
+			break;
+		case 3:
+			// operand of the wrong type, which parses but cannot be evaluated
+			this->token(out, "&&");
+			this->literal(out);
+			this->token(out, "+");
+			this->token(out, "true");
+			break;
+		default:
+			// misspelled operator
+			this->token(out, "&");
+			break;
+		}
+	}
+} // namespace calc
@@ -0,0 +1,101 @@
+/**
+ * @file		generator.hpp
+ * Contains type declarations for generating random scripts.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_GENERATOR_HPP
+#define CALC_GENERATOR_HPP
+
+#include "config.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace calc {
+	/**
+	 * The relative weights of each kind of operator in generated
+	 * expressions. A weight of zero disables the operator kind.
+	 */
+	struct operator_mix {
+		unsigned int additive = 4;
+		unsigned int multiplicative = 3;
+		unsigned int unary = 1;
+		unsigned int ordering = 2;
+		unsigned int equality = 1;
+		unsigned int logical = 2;
+
+		/**
+		 * Parses a list of comma-separated @c name:weight pairs, such as
+		 * @c "additive:4,logical:0", and updates the named weights.
+		 * @param spec	The list of weights.
+		 * @return		@c true if @p spec was valid, @c false otherwise.
+		 */
+		bool parse(const std::string& spec);
+	};
+
+	/**
+	 * Options that control the shape of generated scripts.
+	 */
+	struct generator_options {
+		/// The seed of the pseudorandom number generator.
+		std::uint64_t seed = 1;
+		/// The maximum depth of each abstract syntax tree.
+		unsigned int max_depth = 4;
+		/// The maximum number of operands in a chain of operators with the
+		/// same precedence, such as @c a+b-c.
+		unsigned int max_width = 3;
+		operator_mix mix;
+		/// The probability that an expression has a boolean type.
+		double boolean_ratio = 0.5;
+		/// The maximum number of digits in an integer literal (1 to 10).
+		unsigned int max_digits = 4;
+		/// The probability of a blank between two adjacent tokens.
+		double whitespace_density = 0.8;
+		/// The probability that a line contains an error.
+		double error_rate = 0.0;
+	};
+
+	/**
+	 * Generates lines of random but reproducible expressions. Unless errors
+	 * are requested, every line parses and has a well-defined type. Divisors
+	 * are nonzero literals, although evaluation may still overflow.
+	 */
+	class expr_generator {
+	public:
+		explicit expr_generator(const generator_options& options);
+
+		const generator_options& options() const noexcept {
+			return this->_options;
+		}
+
+		/**
+		 * Appends a single line, including the terminating newline.
+		 * @param out	The string to append to.
+		 */
+		void generate_line(std::string& out);
+
+	private:
+		generator_options _options;
+		std::uint64_t _state;
+		std::uint64_t _blank_threshold;
+		std::uint64_t _tab_threshold;
+
+		std::uint64_t next() noexcept;
+		unsigned int uniform(unsigned int n) noexcept;
+		bool bernoulli(double p) noexcept;
+
+		void blank(std::string& out);
+		void token(std::string& out, const char* text);
+		void literal(std::string& out, bool nonzero = false);
+
+		void integer_expr(std::string& out, unsigned int depth, int max_level);
+		void boolean_expr(std::string& out, unsigned int depth, int max_level);
+		void inject_error(std::string& out);
+	};
+} // namespace calc
+
+#endif // CALC_GENERATOR_HPP
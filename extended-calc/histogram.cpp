@@ -0,0 +1,81 @@
+/**
+ * @file		histogram.cpp
+ * Contains type definitions for recording latency distributions.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#include "histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace calc {
+	const unsigned int latency_histogram::sub_bucket_bits;
+	const std::size_t latency_histogram::sub_bucket_count;
+	const std::size_t latency_histogram::bucket_count;
+
+	/// Returns the position of the most significant set bit of @p value,
+	/// which must not be zero.
+	static unsigned int highest_bit(std::uint64_t value) noexcept {
+#if defined(__GNUC__)
+		return 63 - __builtin_clzll(value);
+#else
+		unsigned int bit = 0;
+		while (value >>= 1)
+			bit++;
+		return bit;
+#endif
+	}
+
+	latency_histogram::latency_histogram() noexcept :
+		_count(0), _total(0), _max(0)
+	{
+		std::fill(this->_buckets, this->_buckets + bucket_count, 0);
+	}
+
+	void latency_histogram::record(std::uint64_t value) noexcept {
+		this->_buckets[bucket_index(value)]++;
+		this->_count++;
+		this->_total += value;
+		this->_max = std::max(this->_max, value);
+	}
+
+	std::uint64_t latency_histogram::percentile(double p) const noexcept {
+		if (this->_count == 0)
+			return 0;
+
+		const double clamped = std::min(std::max(p, 0.0), 100.0);
+		const std::uint64_t rank = std::max<std::uint64_t>(1,
+			static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * this->_count)));
+		std::uint64_t seen = 0;
+
+		for (std::size_t i = 0; i < bucket_count; i++) {
+			seen += this->_buckets[i];
+			if (seen >= rank)
+				return std::min(bucket_upper_bound(i), this->_max);
+		}
+		return this->_max;
+	}
+
+	std::size_t latency_histogram::bucket_index(std::uint64_t value) noexcept {
+		if (value < sub_bucket_count)
+			return static_cast<std::size_t>(value);
+
+		// values in [2^k, 2^(k + 1)) share the 32 buckets starting at
+		// (k - 4) * 32, each covering 2^(k - 5) values
+		const unsigned int shift = highest_bit(value) - sub_bucket_bits;
+		return shift * sub_bucket_count + static_cast<std::size_t>(value >> shift);
+	}
+
+	std::uint64_t latency_histogram::bucket_upper_bound(std::size_t index) noexcept {
+		if (index < 2 * sub_bucket_count)
+			return index;
+
+		const unsigned int shift = static_cast<unsigned int>(index / sub_bucket_count - 1);
+		const std::uint64_t mantissa = index - shift * sub_bucket_count;
+		return ((mantissa + 1) << shift) - 1;
+	}
+} // namespace calc
@@ -0,0 +1,69 @@
+/**
+ * @file		histogram.hpp
+ * Contains type declarations for recording latency distributions.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_HISTOGRAM_HPP
+#define CALC_HISTOGRAM_HPP
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace calc {
+	/**
+	 * Counts values in log-linear buckets, in the manner of an HDR
+	 * histogram. Values below 64 are counted exactly; above that, each power
+	 * of two is split into 32 buckets, so a reported percentile is within
+	 * about 3% of the true value. Recording a value takes constant time and
+	 * no allocation.
+	 */
+	class latency_histogram {
+	public:
+		latency_histogram() noexcept;
+
+		void record(std::uint64_t value) noexcept;
+
+		std::uint64_t count() const noexcept {
+			return this->_count;
+		}
+
+		std::uint64_t total() const noexcept {
+			return this->_total;
+		}
+
+		std::uint64_t max() const noexcept {
+			return this->_max;
+		}
+
+		/**
+		 * Returns the value below which a given percentage of the recorded
+		 * values fall.
+		 * @param p		A percentage between 0 and 100.
+		 * @return		The upper bound of the bucket that contains the
+		 * 				percentile, or 0 if no values were recorded.
+		 */
+		std::uint64_t percentile(double p) const noexcept;
+
+	private:
+		static const unsigned int sub_bucket_bits = 5;
+		static const std::size_t sub_bucket_count = 1 << sub_bucket_bits;
+		static const std::size_t bucket_count =
+			(64 - sub_bucket_bits) * sub_bucket_count + sub_bucket_count;
+
+		std::uint64_t _buckets[bucket_count];
+		std::uint64_t _count;
+		std::uint64_t _total;
+		std::uint64_t _max;
+
+		static std::size_t bucket_index(std::uint64_t value) noexcept;
+		static std::uint64_t bucket_upper_bound(std::size_t index) noexcept;
+	};
+} // namespace calc
+
+#endif // CALC_HISTOGRAM_HPP
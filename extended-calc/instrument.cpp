@@ -0,0 +1,324 @@
+/**
+ * @file		instrument.cpp
+ * Contains function definitions for instrumenting the calculator.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#include "instrument.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace calc {
+	namespace detail {
+		thread_local phase current_phase = phase::none;
+		bool timing = false;
+	} // namespace detail
+
+	namespace {
+		struct phase_counters {
+			std::atomic<std::size_t> allocations;
+			std::atomic<std::size_t> deallocations;
+			std::atomic<std::size_t> bytes;
+			std::atomic<std::size_t> peak_live_bytes;
+		};
+
+		// these are constant-initialized, so allocations made during the
+		// dynamic initialization of other translation units are safe
+		phase_counters counters[phase_count];
+		std::atomic<std::int64_t> live_bytes(0);
+		std::atomic<bool> tracking_enabled(false);
+
+		void update_peak(std::atomic<std::size_t>& peak, std::size_t value) {
+			std::size_t current = peak.load(std::memory_order_relaxed);
+			while (current < value
+			       && !peak.compare_exchange_weak(current, value,
+			                                      std::memory_order_relaxed))
+				;
+		}
+
+		/// A span recorded by a phase scope. Times are in nanoseconds.
+		struct trace_event {
+			std::uint64_t start;
+			std::uint64_t duration;
+			std::uint32_t expression;
+			phase p;
+		};
+
+		/// The number of spans that each thread keeps.
+		const std::size_t trace_buffer_capacity = 1 << 20;
+
+		/// The spans recorded by a single thread, oldest first once the
+		/// buffer has wrapped around.
+		struct trace_buffer {
+			std::vector<trace_event> events;
+			std::uint64_t recorded;
+			unsigned int thread_id;
+		};
+
+		std::mutex trace_mutex;
+		/// Owns the buffer of every thread, so that buffers outlive their
+		/// threads until the trace is written.
+		std::vector<std::unique_ptr<trace_buffer>> trace_buffers;
+		bool tracing = false;
+		std::uint64_t trace_epoch = 0;
+		thread_local std::uint32_t trace_expression = 0;
+		thread_local std::uint64_t phase_times[phase_count];
+
+		trace_buffer& thread_trace_buffer() {
+			thread_local trace_buffer* buffer = nullptr;
+
+			if (!buffer) {
+				std::unique_ptr<trace_buffer> b(new trace_buffer);
+				b->events.resize(trace_buffer_capacity);
+				b->recorded = 0;
+
+				std::lock_guard<std::mutex> lock(trace_mutex);
+				b->thread_id = static_cast<unsigned int>(trace_buffers.size() + 1);
+				buffer = b.get();
+				trace_buffers.push_back(std::move(b));
+			}
+			return *buffer;
+		}
+	} // namespace
+
+	namespace detail {
+		std::uint64_t phase_clock() noexcept {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		void end_timed_scope(phase p, std::uint64_t start) noexcept {
+			// the scope began before timing started
+			if (start == 0)
+				return;
+
+			const std::uint64_t end = phase_clock();
+			phase_times[static_cast<std::size_t>(p)] += end - start;
+			if (!tracing)
+				return;
+
+			try {
+				trace_buffer& buffer = thread_trace_buffer();
+
+				// spans that began before tracing started are clipped
+				start = std::max(start, trace_epoch);
+				buffer.events[buffer.recorded % trace_buffer_capacity] = {
+					start, end - start, trace_expression, p
+				};
+				buffer.recorded++;
+			}
+			catch (const std::bad_alloc&) {
+				// a thread without a buffer records nothing
+			}
+		}
+	} // namespace detail
+
+	const char* phase_name(phase p) noexcept {
+		switch (p) {
+			case phase::none:
+				return "other";
+			case phase::lex:
+				return "lex";
+			case phase::parse:
+				return "parse";
+			case phase::evaluate:
+				return "evaluate";
+			case phase::output:
+				return "output";
+			case phase::refill:
+				return "refill";
+		}
+		return "unknown";
+	}
+
+	void enable_allocation_tracking() noexcept {
+		tracking_enabled.store(true, std::memory_order_relaxed);
+	}
+
+	bool allocation_tracking_enabled() noexcept {
+		return tracking_enabled.load(std::memory_order_relaxed);
+	}
+
+	void record_allocation(std::size_t size) noexcept {
+		if (!allocation_tracking_enabled())
+			return;
+
+		phase_counters& c = counters[static_cast<std::size_t>(current_phase())];
+		c.allocations.fetch_add(1, std::memory_order_relaxed);
+		c.bytes.fetch_add(size, std::memory_order_relaxed);
+
+		const std::int64_t live = live_bytes.fetch_add(size, std::memory_order_relaxed)
+		                          + static_cast<std::int64_t>(size);
+		// blocks allocated before tracking was enabled can drive the count
+		// below zero when they are freed
+		if (live > 0)
+			update_peak(c.peak_live_bytes, static_cast<std::size_t>(live));
+	}
+
+	void record_deallocation(std::size_t size) noexcept {
+		if (!allocation_tracking_enabled())
+			return;
+
+		phase_counters& c = counters[static_cast<std::size_t>(current_phase())];
+		c.deallocations.fetch_add(1, std::memory_order_relaxed);
+		live_bytes.fetch_sub(size, std::memory_order_relaxed);
+	}
+
+	allocation_stats phase_allocation_stats(phase p) noexcept {
+		const phase_counters& c = counters[static_cast<std::size_t>(p)];
+		return {
+			c.allocations.load(std::memory_order_relaxed),
+			c.deallocations.load(std::memory_order_relaxed),
+			c.bytes.load(std::memory_order_relaxed),
+			c.peak_live_bytes.load(std::memory_order_relaxed)
+		};
+	}
+
+	void print_allocation_stats(std::ostream& out, std::size_t expr_count) {
+		const std::ios_base::fmtflags flags = out.flags();
+		const std::streamsize precision = out.precision();
+		allocation_stats total = {0, 0, 0, 0};
+
+		out << std::fixed << std::setprecision(1)
+		    << std::left << std::setw(10) << "phase" << std::right
+		    << std::setw(12) << "allocs" << std::setw(12) << "frees"
+		    << std::setw(14) << "bytes" << std::setw(14) << "peak live"
+		    << std::setw(10) << "avg size" << std::setw(13) << "allocs/expr"
+		    << std::setw(13) << "bytes/expr" << '\n';
+
+		auto print_row = [&](const char* name, const allocation_stats& s) {
+			const double n = expr_count ? static_cast<double>(expr_count) : 1.0;
+			out << std::left << std::setw(10) << name << std::right
+			    << std::setw(12) << s.allocations << std::setw(12) << s.deallocations
+			    << std::setw(14) << s.bytes << std::setw(14) << s.peak_live_bytes
+			    << std::setw(10) << (s.allocations ? static_cast<double>(s.bytes) / s.allocations : 0.0)
+			    << std::setw(13) << s.allocations / n
+			    << std::setw(13) << s.bytes / n << '\n';
+		};
+
+		for (std::size_t i = 0; i < phase_count; i++) {
+			const phase p = static_cast<phase>(i);
+			const allocation_stats s = phase_allocation_stats(p);
+			print_row(phase_name(p), s);
+			total.allocations += s.allocations;
+			total.deallocations += s.deallocations;
+			total.bytes += s.bytes;
+			if (s.peak_live_bytes > total.peak_live_bytes)
+				total.peak_live_bytes = s.peak_live_bytes;
+		}
+		print_row("total", total);
+		out << expr_count << " expressions\n";
+
+		out.flags(flags);
+		out.precision(precision);
+	}
+
+	void start_phase_timing() {
+		detail::timing = true;
+	}
+
+	std::uint64_t phase_time(phase p) noexcept {
+		return phase_times[static_cast<std::size_t>(p)];
+	}
+
+	void start_tracing() {
+		// allocate the buffer of the calling thread up front
+		thread_trace_buffer();
+		trace_epoch = detail::phase_clock();
+		tracing = true;
+		start_phase_timing();
+	}
+
+	void set_trace_expression(std::size_t n) noexcept {
+		trace_expression = static_cast<std::uint32_t>(n);
+	}
+
+	void write_trace(std::ostream& out) {
+		std::lock_guard<std::mutex> lock(trace_mutex);
+		const std::ios_base::fmtflags flags = out.flags();
+		const std::streamsize precision = out.precision();
+		std::uint64_t dropped = 0;
+		bool first = true;
+
+		// timestamps are in microseconds
+		out << std::fixed << std::setprecision(3)
+		    << "{\"traceEvents\":[\n";
+		for (const std::unique_ptr<trace_buffer>& buffer : trace_buffers) {
+			const std::uint64_t count = std::min<std::uint64_t>(
+				buffer->recorded, trace_buffer_capacity);
+			const std::uint64_t oldest = buffer->recorded - count;
+			dropped += oldest;
+
+			out << (first ? "" : ",\n")
+			    << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+			    << buffer->thread_id << ",\"args\":{\"name\":\"thread "
+			    << buffer->thread_id << "\"}}";
+			first = false;
+
+			for (std::uint64_t i = oldest; i < buffer->recorded; i++) {
+				const trace_event& e = buffer->events[i % trace_buffer_capacity];
+				out << ",\n{\"name\":\"" << phase_name(e.p)
+				    << "\",\"cat\":\"calc\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+				    << buffer->thread_id
+				    << ",\"ts\":" << (e.start - trace_epoch) / 1000.0
+				    << ",\"dur\":" << e.duration / 1000.0
+				    << ",\"args\":{\"expr\":" << e.expression << "}}";
+			}
+		}
+		out << "\n],\n"
+		    << "\"displayTimeUnit\":\"ns\",\n"
+		    << "\"otherData\":{\"dropped_events\":" << dropped << "}}\n";
+
+		out.flags(flags);
+		out.precision(precision);
+	}
+
+	const std::size_t phase_streambuf::putback_size;
+	const std::size_t phase_streambuf::buffer_size;
+
+	phase_streambuf::phase_streambuf(std::streambuf* source, bool interactive) :
+		_source(source), _interactive(interactive)
+	{
+		this->setg(this->_buffer + putback_size, this->_buffer + putback_size,
+		           this->_buffer + putback_size);
+	}
+
+	phase_streambuf::int_type phase_streambuf::underflow() {
+		if (this->gptr() < this->egptr())
+			return traits_type::to_int_type(*this->gptr());
+
+		CALC_PHASE_SCOPE(refill);
+
+		// move the tail of the previous read into the putback area
+		const std::size_t kept = std::min<std::size_t>(
+			this->gptr() - this->eback(), putback_size);
+		char* const start = this->_buffer + putback_size;
+		std::memmove(start - kept, this->gptr() - kept, kept);
+
+		std::streamsize n = buffer_size;
+		if (this->_interactive) {
+			// wait for one character, then take whatever else has arrived
+			if (traits_type::eq_int_type(this->_source->sgetc(), traits_type::eof()))
+				return traits_type::eof();
+			n = std::min(std::max<std::streamsize>(this->_source->in_avail(), 1), n);
+		}
+
+		n = this->_source->sgetn(start, n);
+		this->setg(start - kept, start, start + n);
+		if (n <= 0)
+			return traits_type::eof();
+		return traits_type::to_int_type(*this->gptr());
+	}
+} // namespace calc
@@ -0,0 +1,198 @@
+/**
+ * @file		instrument.hpp
+ * Contains type and function declarations for instrumenting the calculator.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_INSTRUMENT_HPP
+#define CALC_INSTRUMENT_HPP
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+/**
+ * @def CALC_PHASE_SCOPE(P)
+ * Attributes the rest of the enclosing block to the phase @c calc::phase::P.
+ * Expands to nothing unless the project is configured with
+ * @c ENABLE_INSTRUMENTATION.
+ */
+#if ENABLE_INSTRUMENTATION
+	#define CALC_PHASE_SCOPE_CONCAT2(A, B) A##B
+	#define CALC_PHASE_SCOPE_CONCAT(A, B) CALC_PHASE_SCOPE_CONCAT2(A, B)
+	#define CALC_PHASE_SCOPE(P) \
+		::calc::phase_scope CALC_PHASE_SCOPE_CONCAT(calc_phase_scope_, __LINE__)(::calc::phase::P)
+#else
+	#define CALC_PHASE_SCOPE(P) static_cast<void>(0)
+#endif
+
+namespace calc {
+	/// The phases of processing a script that instrumentation distinguishes.
+	enum class phase : unsigned char {
+		none,
+		lex,
+		parse,
+		evaluate,
+		output,
+		refill
+	};
+
+	/// The number of enumerators in calc::phase.
+	const std::size_t phase_count = 6;
+
+	const char* phase_name(phase p) noexcept;
+
+	namespace detail {
+		extern thread_local phase current_phase;
+		/// Set by start_phase_timing() or start_tracing() before any other
+		/// thread is started.
+		extern bool timing;
+
+		std::uint64_t phase_clock() noexcept;
+		void end_timed_scope(phase p, std::uint64_t start) noexcept;
+	} // namespace detail
+
+	/**
+	 * Returns the phase that the calling thread is in.
+	 * @return	The innermost active phase of the calling thread.
+	 */
+	inline phase current_phase() noexcept {
+		return detail::current_phase;
+	}
+
+	/**
+	 * Makes a phase the current phase of the calling thread for the lifetime
+	 * of the scope, then restores the previous phase. Use CALC_PHASE_SCOPE()
+	 * instead of naming this class directly.
+	 */
+	class phase_scope {
+	public:
+		explicit phase_scope(phase p) noexcept :
+			_previous(detail::current_phase),
+			_start(detail::timing ? detail::phase_clock() : 0)
+		{
+			detail::current_phase = p;
+		}
+
+		phase_scope(const phase_scope&) = delete;
+
+		~phase_scope() {
+			if (detail::timing)
+				detail::end_timed_scope(detail::current_phase, this->_start);
+			detail::current_phase = this->_previous;
+		}
+
+		phase_scope& operator=(const phase_scope&) = delete;
+
+	private:
+		phase _previous;
+		std::uint64_t _start;
+	};
+
+	/**
+	 * Allocation counts of a single phase.
+	 */
+	struct allocation_stats {
+		std::size_t allocations;
+		std::size_t deallocations;
+		/// The total number of bytes allocated.
+		std::size_t bytes;
+		/// The largest number of live bytes observed during the phase.
+		std::size_t peak_live_bytes;
+	};
+
+	/**
+	 * Starts attributing allocations to the current phase. Allocations are
+	 * only observed if the program replaces the global allocation functions
+	 * with ones that call record_allocation() and record_deallocation().
+	 */
+	void enable_allocation_tracking() noexcept;
+	bool allocation_tracking_enabled() noexcept;
+
+	void record_allocation(std::size_t size) noexcept;
+	void record_deallocation(std::size_t size) noexcept;
+
+	allocation_stats phase_allocation_stats(phase p) noexcept;
+
+	/**
+	 * Writes a table of the allocation counts of each phase.
+	 * @param out			An output stream.
+	 * @param expr_count	The number of expressions that were processed,
+	 * 						used to compute per-expression averages.
+	 */
+	void print_allocation_stats(std::ostream& out, std::size_t expr_count);
+
+	/**
+	 * Starts measuring the time that each thread spends in each phase.
+	 * Call this before starting other threads.
+	 */
+	void start_phase_timing();
+
+	/**
+	 * Returns the total time that the calling thread has spent in a phase
+	 * since timing started, including nested scopes of other phases.
+	 * @param p		A phase.
+	 * @return		The time spent in @p p, in nanoseconds.
+	 */
+	std::uint64_t phase_time(phase p) noexcept;
+
+	/**
+	 * Starts recording a span for every phase scope, which implies
+	 * start_phase_timing(). Each thread records
+	 * into its own fixed-size ring buffer, so only the most recent spans of
+	 * a long run are kept. Call this before starting other threads.
+	 */
+	void start_tracing();
+
+	/**
+	 * Sets the number of the expression that the calling thread is working
+	 * on, which is attached to each span that it records.
+	 * @param n		The number of the expression.
+	 */
+	void set_trace_expression(std::size_t n) noexcept;
+
+	/**
+	 * Writes the recorded spans of every thread as Chrome trace event JSON,
+	 * which can be loaded into chrome://tracing or Perfetto.
+	 * @param out	An output stream.
+	 */
+	void write_trace(std::ostream& out);
+
+	/**
+	 * Wraps an input stream buffer so that each time it is refilled from
+	 * the underlying buffer, the read is attributed to phase::refill.
+	 */
+	class phase_streambuf : public std::streambuf {
+	public:
+		/**
+		 * Constructs a stream buffer that reads from another one.
+		 * @param source		The underlying stream buffer.
+		 * @param interactive	@c true if a refill should only read the
+		 * 						characters that are already available, so
+		 * 						that it does not wait for a full buffer.
+		 */
+		explicit phase_streambuf(std::streambuf* source, bool interactive = false);
+
+	protected:
+		int_type underflow();
+
+	private:
+		/// The number of characters kept from the previous read so that the
+		/// lexer can put them back.
+		static const std::size_t putback_size = 16;
+		static const std::size_t buffer_size = 4096;
+
+		std::streambuf* _source;
+		bool _interactive;
+		char _buffer[putback_size + buffer_size];
+	};
+} // namespace calc
+
+#endif // CALC_INSTRUMENT_HPP
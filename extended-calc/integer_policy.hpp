@@ -0,0 +1,211 @@
+/**
+ * @file		integer_policy.hpp
+ * Contains the integer width policies.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_INTEGER_POLICY_HPP
+#define CALC_INTEGER_POLICY_HPP
+
+#include "config.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace calc {
+	/**
+	 * Defines the representation of integers and the arithmetic on them.
+	 * Each operation stores its result and returns whether it overflowed.
+	 * An unchecked policy wraps around, as two's complement hardware does,
+	 * and never reports an overflow; a checked policy reports one with the
+	 * compiler's overflow builtins where it has them, which cost one branch
+	 * on the overflow flag.
+	 * @tparam T		The signed integer type.
+	 * @tparam U		The unsigned integer type of the same width.
+	 * @tparam Checked	@c true if overflows are reported.
+	 */
+	template <typename T, typename U, bool Checked>
+	struct basic_integer_policy {
+		typedef T value_type;
+		typedef U unsigned_type;
+
+		static const bool checked = Checked;
+
+		// std::numeric_limits is not specialized for __int128 in strict
+		// standard modes
+		static constexpr T max() noexcept {
+			return static_cast<T>(static_cast<U>(-1) >> 1);
+		}
+
+		static constexpr T min() noexcept {
+			return -max() - 1;
+		}
+
+		static bool negate(T a, T& result) noexcept {
+			if (Checked && a == min())
+				return true;
+			result = static_cast<T>(U(0) - static_cast<U>(a));
+			return false;
+		}
+
+		static bool add(T a, T b, T& result) noexcept {
+			if (!Checked) {
+				result = static_cast<T>(static_cast<U>(a) + static_cast<U>(b));
+				return false;
+			}
+#if HAVE_BUILTIN_OVERFLOW
+			return __builtin_add_overflow(a, b, &result);
+#else
+			if (b > 0 ? a > max() - b : a < min() - b)
+				return true;
+			result = a + b;
+			return false;
+#endif
+		}
+
+		static bool subtract(T a, T b, T& result) noexcept {
+			if (!Checked) {
+				result = static_cast<T>(static_cast<U>(a) - static_cast<U>(b));
+				return false;
+			}
+#if HAVE_BUILTIN_OVERFLOW
+			return __builtin_sub_overflow(a, b, &result);
+#else
+			if (b < 0 ? a > max() + b : a < min() + b)
+				return true;
+			result = a - b;
+			return false;
+#endif
+		}
+
+		static bool multiply(T a, T b, T& result) noexcept {
+			if (!Checked) {
+				result = static_cast<T>(static_cast<U>(a) * static_cast<U>(b));
+				return false;
+			}
+#if HAVE_BUILTIN_OVERFLOW
+			return __builtin_mul_overflow(a, b, &result);
+#else
+			if (a != 0 && b != 0
+			    && ((a == -1 && b == min()) || (b == -1 && a == min())
+			        || (a != -1 && b != -1 && (a * b) / b != a)))
+				return true;
+			result = a * b;
+			return false;
+#endif
+		}
+
+		/// Divides @p a by @p b, which is not zero.
+		static bool divide(T a, T b, T& result) noexcept {
+			if (b == -1) {
+				// min() / -1 traps on most hardware, so it is negated instead
+				return negate(a, result);
+			}
+			result = a / b;
+			return false;
+		}
+
+		/// Takes @p a modulo @p b, which is not zero.
+		static bool modulo(T a, T b, T& result) noexcept {
+			if (b == -1) {
+				// min() % -1 overflows in the division that computes it
+				result = 0;
+				return false;
+			}
+			result = a % b;
+			return false;
+		}
+
+		/**
+		 * Converts a string of decimal digits.
+		 * @param first		The first digit.
+		 * @param last		The end of the digits.
+		 * @param result	The value, if it is representable.
+		 * @return			@c false if the value is not representable.
+		 */
+		template <typename CharT>
+		static bool from_digits(const CharT* first, const CharT* last, T& result) noexcept {
+			// digits are accumulated unsigned; the limit is max()
+			const U limit = static_cast<U>(max());
+			U value = 0;
+			for (; first != last; ++first) {
+				const U digit = static_cast<U>(*first - CharT('0'));
+				if (value > (limit - digit) / 10)
+					return false;
+				value = value * 10 + digit;
+			}
+			result = static_cast<T>(value);
+			return true;
+		}
+
+		static std::string to_string(T v) {
+			char digits[48];
+			char* p = digits + sizeof(digits);
+			U magnitude = v < 0 ? U(0) - static_cast<U>(v) : static_cast<U>(v);
+			do {
+				*--p = static_cast<char>('0' + magnitude % 10);
+				magnitude /= 10;
+			} while (magnitude != 0);
+			if (v < 0)
+				*--p = '-';
+			return std::string(p, digits + sizeof(digits));
+		}
+	};
+
+	template <unsigned int Width>
+	struct integer_policy;
+
+	/// 32-bit integers, which wrap around like the emitted code does.
+	template <>
+	struct integer_policy<32> : basic_integer_policy<std::int32_t, std::uint32_t, false> {
+		static const char* range_message() noexcept {
+			return "Integer literal is outside the range of -(2^31) to 2^31 - 1.";
+		}
+	};
+
+	/// 64-bit integers, whose overflows are errors.
+	template <>
+	struct integer_policy<64> : basic_integer_policy<std::int64_t, std::uint64_t, true> {
+		static const char* range_message() noexcept {
+			return "Integer literal is outside the range of -(2^63) to 2^63 - 1.";
+		}
+	};
+
+#if HAVE_INT128
+	/// 128-bit integers, whose overflows are errors.
+	template <>
+	struct integer_policy<128> : basic_integer_policy<__int128, unsigned __int128, true> {
+		static const char* range_message() noexcept {
+			return "Integer literal is outside the range of -(2^127) to 2^127 - 1.";
+		}
+	};
+#endif
+
+	/// The integer policy selected by CALC_INTEGER_WIDTH.
+	typedef integer_policy<CALC_INTEGER_WIDTH> default_integer_policy;
+
+	/// The type of integer literals and values.
+	typedef default_integer_policy::value_type integer_t;
+
+	/**
+	 * Writes an integer in decimal, which the stream inserters do not do
+	 * for every width.
+	 */
+	template <typename CharT, class Traits>
+	inline std::basic_ostream<CharT, Traits>&
+	write_integer(std::basic_ostream<CharT, Traits>& out, integer_t v) {
+		if (sizeof(integer_t) <= sizeof(long long))
+			return out << static_cast<long long>(v);
+		const std::string digits = default_integer_policy::to_string(v);
+		std::basic_string<CharT, Traits> s;
+		for (char c : digits)
+			s.push_back(out.widen(c));
+		return out << s;
+	}
+} // namespace calc
+
+#endif // CALC_INTEGER_POLICY_HPP
@@ -16,6 +16,7 @@
 #include <istream>
 #include <list>
 
+#include "instrument.hpp"
 #include "token.hpp"
 
 namespace calc {
@@ -48,9 +49,11 @@ namespace calc {
 		 * @param sb	Pointer to a stream buffer.
 		 */
 		explicit basic_lexer(streambuf_type* sb) :
-			_traits(), _in(sb), _position_helper(), _token_start_offset(0)
+			_traits(), _in(sb), _position_helper(), _offset(0),
+			_token_start_offset(0), _token_count(0)
 		{
 			this->_in.exceptions(std::ios_base::badbit);
+			this->position_helper().utf8(this->traits().utf8());
 		}
 
 		/**
@@ -66,12 +69,84 @@ namespace calc {
 			this->_in.clear(in.rdstate() & ~std::ios_base::failbit);
 		}
 
+		/**
+		 * A position in the input that the lexer can return to. A checkpoint
+		 * is only an offset into the characters that the lexer retains, so
+		 * it is cheap to take and to copy.
+		 */
+		class checkpoint_type {
+			friend class basic_lexer;
+
+		public:
+			std::size_t offset() const noexcept {
+				return this->_offset;
+			}
+
+		private:
+			std::size_t _offset;
+
+			explicit checkpoint_type(std::size_t offset) noexcept :
+				_offset(offset)
+			{}
+		};
+
 		/**
 		 * Extracts the next token from the input stream.
 		 * @return	The extracted token.
 		 */
 		token_type next_token();
 
+		/**
+		 * Returns the current position in the input.
+		 * @return	A checkpoint that restore() can return to.
+		 */
+		checkpoint_type checkpoint() const noexcept {
+			return checkpoint_type(this->offset());
+		}
+
+		/**
+		 * Returns to a checkpoint, so that the next token is extracted from
+		 * the checkpoint's position. Since every character that was read is
+		 * retained, this takes constant time, however far back the
+		 * checkpoint is, and never pushes characters back into the stream
+		 * buffer.
+		 * @param cp	A checkpoint at or before the current position.
+		 */
+		void restore(const checkpoint_type& cp) noexcept {
+			this->rewind(cp.offset());
+		}
+
+		/**
+		 * Starts over on whatever the stream buffer holds now, as if the
+		 * lexer were new, but keeps the storage of the retained script, so
+		 * that a lexer can be reused for many small inputs without
+		 * allocating. Extents of earlier tokens become meaningless.
+		 */
+		void reset() noexcept {
+			this->position_helper().clear();
+			this->_in.clear();
+			this->_offset = 0;
+			this->_token_start_offset = 0;
+			this->_token_count = 0;
+		}
+
+		/**
+		 * Clears the end-of-file state of the input stream, so that the
+		 * lexer goes on with characters that the stream buffer gets after
+		 * it ran out.
+		 */
+		void resume() noexcept {
+			this->_in.clear();
+		}
+
+		/**
+		 * Returns the number of tokens extracted so far.
+		 * @return	The number of calls to next_token().
+		 */
+		std::size_t token_count() const noexcept {
+			return this->_token_count;
+		}
+
 		/**
 		 * Returns the current locale associated with the lexer.
 		 * @return	The current locale associated with the lexer.
@@ -86,7 +161,29 @@ namespace calc {
 		 * @return		The locale before the call to this function.
 		 */
 		locale_type imbue(const locale_type& loc) {
-			return this->traits().imbue(loc);
+			locale_type temp(this->traits().imbue(loc));
+			this->position_helper().utf8(this->traits().utf8());
+			return temp;
+		}
+
+		/**
+		 * Returns whether the input is treated as UTF-8, which is the
+		 * default if the locale uses UTF-8. A UTF-8 script is stored as
+		 * is, and its column numbers count code points.
+		 * @return	@c true if the input is treated as UTF-8.
+		 */
+		bool utf8() const noexcept {
+			return this->traits().utf8();
+		}
+
+		/**
+		 * Turns UTF-8 mode on or off. This has no effect on lexers of
+		 * wide characters.
+		 * @param enable	Whether to treat the input as UTF-8.
+		 */
+		void utf8(bool enable) noexcept {
+			this->traits().utf8(enable);
+			this->position_helper().utf8(this->traits().utf8());
 		}
 
 		/**
@@ -106,11 +203,17 @@ namespace calc {
 		traits_type _traits;
 		/// The input stream.
 		istream_type _in;
-		/// A helper object.
+		/// A helper object, which also retains every character that was
+		/// read from the input stream.
 		position_helper_type _position_helper;
+		/// The offset of the next character to be lexed, which is less than
+		/// the size of the retained script after a checkpoint is restored.
+		std::size_t _offset;
 		/// The currently scanned token's offset from the beginning of the
 		/// script.
 		std::size_t _token_start_offset;
+		/// The number of tokens extracted so far.
+		std::size_t _token_count;
 
 		traits_type& traits() noexcept {
 			return this->_traits;
@@ -137,7 +240,7 @@ namespace calc {
 		}
 
 		std::size_t offset() const noexcept {
-			return this->script().size();
+			return this->_offset;
 		}
 
 		std::size_t token_start_offset() const noexcept {
@@ -161,10 +264,10 @@ namespace calc {
 		int_type peek();
 		void unget();
 		void ignore();
-		void putback(CharT c);
+		bool fill();
+		void rewind(std::size_t offset) noexcept;
 
 		void skip_blanks();
-		void rewind_blanks();
 
 		bool matches(const CharT* str, std::size_t n = Traits::npos);
 
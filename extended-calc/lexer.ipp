@@ -12,24 +12,22 @@
 #define CALC_LEXER_IPP
 
 #include <algorithm>
-#include <functional>
 
 namespace calc {
 	template <typename CharT, class Traits>
 	typename basic_lexer<CharT, Traits>::token_type
 	basic_lexer<CharT, Traits>::next_token() {
+		CALC_PHASE_SCOPE(lex);
+		this->_token_count++;
 		this->skip_blanks();
 
 		// set token offset to current offset
 		this->token_start_offset(this->offset());
 
 		if (!this->eof()) {
-			const CharT carriage_return = this->traits().widen('\r');
-			const CharT line_feed = this->traits().widen('\n');
-
 			const CharT c = Traits::to_char_type(this->peek());
 
-			if (Traits::eq(c, carriage_return) || Traits::eq(c, line_feed))
+			if (this->traits().is_newline(c))
 				return this->lex_newline();
 			if (this->traits().is_digit(c))
 				return this->lex_integer();
@@ -38,7 +36,9 @@ namespace calc {
 			if (this->scan(this->traits().false_name()))
 				return token_type(this->extent(), token_kind::boolean);
 
-			for (const auto& entry : this->traits().operator_table())
+			// operators are ordered longest first, which keeps "<=" from
+			// being lexed as "<" followed by "="
+			for (const auto& entry : this->traits().operators())
 				if (this->scan(entry.second))
 					return token_type(this->extent(), entry.first);
 
@@ -52,38 +52,62 @@ namespace calc {
 	template <typename CharT, class Traits>
 	typename basic_lexer<CharT, Traits>::int_type
 	basic_lexer<CharT, Traits>::get() {
-		const int_type c = this->_in.get();
+		const int_type c = this->peek();
 		if (!Traits::is_eof(c))
-			this->script().push_back(Traits::to_char_type(c));
+			this->_offset++;
 		return c;
 	}
 
 	template <typename CharT, class Traits>
 	typename basic_lexer<CharT, Traits>::int_type
 	basic_lexer<CharT, Traits>::peek() {
-		return this->_in.peek();
+		if (this->offset() == this->script().size() && !this->fill())
+			return char_traits_type::eof();
+		return char_traits_type::to_int_type(this->script()[this->offset()]);
 	}
 
 	template <typename CharT, class Traits>
 	void basic_lexer<CharT, Traits>::unget() {
-		this->_in.unget();
-		if (!this->_in.bad())
-			this->script().pop_back();
+		assert(this->offset() > 0);
+		this->_offset--;
 	}
 
 	template <typename CharT, class Traits>
 	void basic_lexer<CharT, Traits>::ignore() {
-		const int_type c = this->_in.peek();
-		if (!Traits::is_eof(c))
-			this->script().push_back(Traits::to_char_type(c));
-		this->_in.ignore();
+		this->get();
 	}
 
 	template <typename CharT, class Traits>
-	void basic_lexer<CharT, Traits>::putback(CharT c) {
-		this->_in.putback(c);
-		if (!this->_in.bad())
-			this->script().pop_back();
+	bool basic_lexer<CharT, Traits>::fill() {
+		const std::size_t fill_size = 4096;
+		string_type& script = this->script();
+		const std::size_t size = script.size();
+		const std::streamsize available = this->_in.rdbuf()->in_avail();
+
+		// take whatever the stream buffer holds without blocking, so that
+		// an interactive stream is never read past the end of its input
+		if (available > 0) {
+			const std::size_t n = std::min(static_cast<std::size_t>(available), fill_size);
+			script.resize(size + n);
+			script.resize(size + this->_in.readsome(&script[size], n));
+			return script.size() > size;
+		}
+
+		const int_type c = this->_in.get();
+		if (Traits::is_eof(c))
+			return false;
+		script.push_back(Traits::to_char_type(c));
+		return true;
+	}
+
+	template <typename CharT, class Traits>
+	void basic_lexer<CharT, Traits>::rewind(std::size_t offset) noexcept {
+		assert(offset <= this->offset());
+		this->_offset = offset;
+
+		// forget the lines that start after the new offset, since lexing
+		// their newlines again adds them back
+		this->position_helper().remove_line_starts_after(offset);
 	}
 
 	template <typename CharT, class Traits>
@@ -96,26 +120,13 @@ namespace calc {
 		}
 	}
 
-	template <typename CharT, class Traits>
-	void basic_lexer<CharT, Traits>::rewind_blanks() {
-		while (!this->script().empty()) {
-			const CharT c = this->script().back();
-			if (!this->traits().is_blank(c))
-				break;
-			this->putback(c);
-		}
-	}
-
 	template <typename CharT, class Traits>
 	bool basic_lexer<CharT, Traits>::matches(const CharT* str, std::size_t n) {
 		const std::size_t start_offset = this->offset();
 		const bool result = this->scan(str, n);
-		const std::size_t end_offset = this->offset();
 
 		// set stream position to beginning of search string, if found
-		if (result)
-			for (std::size_t i = 0; i < end_offset - start_offset; i++)
-				this->putback(this->script().back());
+		this->_offset = start_offset;
 
 		return result;
 	}
@@ -123,26 +134,19 @@ namespace calc {
 	template <typename CharT, class Traits>
 	bool basic_lexer<CharT, Traits>::scan(const CharT* str, std::size_t n) {
 		const std::size_t len = n == Traits::npos ? Traits::length(str) : n;
+		const std::size_t start_offset = this->offset();
 
-		bool result = true;
-		std::size_t count = 0;
-
-		while (count < len) {
-			if (this->eof()
-			    || !Traits::eq(str[count++], Traits::to_char_type(this->get())))
-			{
-				result = false;
-				break;
+		for (std::size_t i = 0; i < len; i++) {
+			const int_type c = this->get();
+			// undo extraction operation(s) if entire search string couldn't
+			// be matched
+			if (Traits::is_eof(c) || !Traits::eq(str[i], Traits::to_char_type(c))) {
+				this->_offset = start_offset;
+				return false;
 			}
 		}
 
-		// undo extraction operation(s) if entire search string couldn't be
-		// matched
-		if (!result)
-			for (std::size_t i = 0; i < count; i++)
-				this->putback(this->script().back());
-
-		return result;
+		return true;
 	}
 
 	template <typename CharT, class Traits>
@@ -165,14 +169,12 @@ namespace calc {
 	basic_lexer<CharT, Traits>::lex_unknown() {
 		assert(!this->eof());
 
-		const CharT carriage_return = this->traits().widen('\r');
-		const CharT line_feed = this->traits().widen('\n');
-		const auto& operator_table = this->traits().operator_table();
+		const auto& operators = this->traits().operators();
 
 		CharT c = Traits::to_char_type(this->peek());
 
 		assert(!this->traits().is_blank(c));
-		assert(!Traits::eq(c, carriage_return) && !Traits::eq(c, line_feed));
+		assert(!this->traits().is_newline(c));
 		assert(!this->traits().is_digit(c));
 		assert(!this->matches(this->traits().true_name()));
 		assert(!this->matches(this->traits().false_name()));
@@ -180,14 +182,14 @@ namespace calc {
 		do {
 			const CharT c = Traits::to_char_type(this->peek());
 			if (this->traits().is_blank(c)
-			    || (Traits::eq(c, carriage_return) || Traits::eq(c, line_feed))
+			    || this->traits().is_newline(c)
 			    || this->traits().is_digit(c)
 			    || this->matches(this->traits().true_name())
 			    || this->matches(this->traits().false_name()))
 				break;
 
-			const bool matches_operator = std::any_of(operator_table.cbegin(),
-				                                      operator_table.cend(),
+			const bool matches_operator = std::any_of(operators.cbegin(),
+				                                      operators.cend(),
 			[this] (const auto& entry) mutable -> bool {
 				return this->matches(entry.second);
 			});
@@ -207,8 +209,8 @@ namespace calc {
 	basic_lexer<CharT, Traits>::lex_newline() {
 		assert(!this->eof());
 
-		const CharT carriage_return = this->traits().widen('\r');
-		const CharT line_feed = this->traits().widen('\n');
+		const CharT carriage_return = this->traits().carriage_return();
+		const CharT line_feed = this->traits().line_feed();
 
 		CharT c = Traits::to_char_type(this->get());
 
@@ -233,8 +235,14 @@ namespace calc {
 	template <typename CharT, class Traits>
 	typename basic_lexer<CharT, Traits>::token_type
 	basic_lexer<CharT, Traits>::lex_integer() {
-		auto is_digit = std::bind(&Traits::is_digit, &this->traits(), std::placeholders::_1);
-		assert(this->scan_if(is_digit));
+		const Traits& traits = this->traits();
+		auto is_digit = [&traits] (CharT c) -> bool {
+			return traits.is_digit(c);
+		};
+		// the scan must stay outside of assert(), which NDEBUG compiles away
+		const bool scanned = this->scan_if(is_digit);
+		assert(scanned);
+		static_cast<void>(scanned);
 		return token_type(this->extent(), token_kind::integer);
 	}
 
@@ -21,6 +21,15 @@ namespace calc {
 
 	/// A lexer of @c wchar_t characters.
 	typedef basic_lexer<wchar_t> wlexer;
+
+	template <typename CharT, class Traits = symbol_traits<CharT>>
+	class basic_token_buffer;
+
+	/// A token buffer of @c char characters.
+	typedef basic_token_buffer<char> token_buffer;
+
+	/// A token buffer of @c wchar_t characters.
+	typedef basic_token_buffer<wchar_t> wtoken_buffer;
 } // namespace calc
 
 #endif // CALC_LEXER_FWD_HPP
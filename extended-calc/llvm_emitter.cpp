@@ -0,0 +1,238 @@
+/**
+ * @file		llvm_emitter.cpp
+ * Contains type definitions for emitting LLVM intermediate representation.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#include "llvm_emitter.hpp"
+
+#include <sstream>
+#include <stdexcept>
+
+namespace calc {
+	/**
+	 * Builds the body of a single LLVM function from an expression. Values
+	 * are numbered in the order that they are defined, starting at %1 (the
+	 * unnamed entry block is %0), and basic blocks are named after the
+	 * function.
+	 */
+	class llvm_function_builder : public expr_visitor {
+	public:
+		explicit llvm_function_builder(const std::string& name) :
+			_name(name), _body(), _operand(), _type("i32"), _value_count(0),
+			_label_count(0)
+		{}
+
+		std::string build(const expr& e) {
+			e.accept(*this);
+			return this->_operand;
+		}
+
+		std::string body() const {
+			return this->_body.str();
+		}
+
+		void visit(const positive_expr& e) {
+			this->_operand = this->build(*e.operand());
+			this->_type = "i32";
+		}
+
+		void visit(const negative_expr& e) {
+			const std::string operand = this->build(*e.operand());
+			this->_operand = this->instruction("sub i32 0, " + operand);
+			this->_type = "i32";
+		}
+
+		void visit(const addition_expr& e) {
+			this->arithmetic("add", e);
+		}
+
+		void visit(const subtraction_expr& e) {
+			this->arithmetic("sub", e);
+		}
+
+		void visit(const multiplication_expr& e) {
+			this->arithmetic("mul", e);
+		}
+
+		void visit(const division_expr& e) {
+			this->division(e, false);
+		}
+
+		void visit(const modulus_expr& e) {
+			this->division(e, true);
+		}
+
+		void visit(const equal_expr& e) {
+			this->comparison("eq", e);
+		}
+
+		void visit(const not_equal_expr& e) {
+			this->comparison("ne", e);
+		}
+
+		void visit(const less_expr& e) {
+			this->comparison("slt", e);
+		}
+
+		void visit(const greater_expr& e) {
+			this->comparison("sgt", e);
+		}
+
+		void visit(const less_equal_expr& e) {
+			this->comparison("sle", e);
+		}
+
+		void visit(const greater_equal_expr& e) {
+			this->comparison("sge", e);
+		}
+
+		void visit(const logical_not_expr& e) {
+			const std::string operand = this->build(*e.operand());
+			this->_operand = this->instruction("xor i1 " + operand + ", true");
+			this->_type = "i1";
+		}
+
+		void visit(const logical_and_expr& e) {
+			this->logical("and", e);
+		}
+
+		void visit(const logical_or_expr& e) {
+			this->logical("or", e);
+		}
+
+		void visit(const boolean& e) {
+			this->_operand = e.to_bool() ? "true" : "false";
+			this->_type = "i1";
+		}
+
+		void visit(const integer& e) {
+			this->_operand = default_integer_policy::to_string(e.to_integer());
+			this->_type = "i32";
+		}
+
+		void visit(const error_expr& e) {
+			throw std::invalid_argument("calc::llvm_emitter::emit");
+		}
+
+		void visit(const big_integer& e) {
+			// the emitted code does 32-bit arithmetic
+			throw std::overflow_error("calc::llvm_emitter::emit");
+		}
+
+	private:
+		std::string _name;
+		std::ostringstream _body;
+		/// The operand that holds the value of the last visited expression.
+		std::string _operand;
+		/// The LLVM type of _operand.
+		const char* _type;
+		std::size_t _value_count;
+		std::size_t _label_count;
+
+		std::string instruction(const std::string& text,
+		                        const char* comment = nullptr)
+		{
+			const std::string result = "%" + std::to_string(++this->_value_count);
+			this->_body << '\t' << result << " = " << text;
+			if (comment)
+				this->_body << " ; " << comment;
+			this->_body << '\n';
+			return result;
+		}
+
+		void terminator(const std::string& text) {
+			this->_body << '\t' << text << '\n';
+		}
+
+		std::string label(const char* what) {
+			return this->_name + '.' + what + '.' + std::to_string(++this->_label_count);
+		}
+
+		void block(const std::string& label) {
+			this->_body << '\n' << label << ":\n";
+		}
+
+		void arithmetic(const char* opcode, const binary_expr& e) {
+			const std::string left = this->build(*e.left_operand());
+			const std::string right = this->build(*e.right_operand());
+			this->_operand = this->instruction(std::string(opcode) + " i32 " + left + ", " + right);
+			this->_type = "i32";
+		}
+
+		void comparison(const char* condition, const binary_expr& e) {
+			// the type of the left operand is known once it is built, so
+			// that no subtree is walked twice
+			const std::string left = this->build(*e.left_operand());
+			const char* const type = this->_type;
+			const std::string right = this->build(*e.right_operand());
+			this->_operand = this->instruction(std::string("icmp ") + condition + ' ' + type + ' ' + left + ", " + right);
+			this->_type = "i1";
+		}
+
+		void division(const binary_expr& e, bool remainder) {
+			const std::string left = this->build(*e.left_operand());
+			const std::string right = this->build(*e.right_operand());
+			const std::string zero_label = this->label("zero");
+			const std::string nonzero_label = this->label("nonzero");
+
+			const std::string is_zero = this->instruction("icmp eq i32 " + right + ", 0", "divisor == 0");
+			this->terminator("br i1 " + is_zero + ", label %" + zero_label + ", label %" + nonzero_label);
+
+			this->block(zero_label);
+			this->terminator(std::string("call void @") + llvm_emitter::division_by_zero_function + "()");
+			this->terminator("unreachable");
+
+			// INT_MIN / -1 overflows, so divide by 1 instead and negate the
+			// dividend, which wraps around like the other operators
+			this->block(nonzero_label);
+			const std::string is_minus_one = this->instruction("icmp eq i32 " + right + ", -1", "divisor == -1");
+			const std::string divisor = this->instruction("select i1 " + is_minus_one + ", i32 1, i32 " + right);
+			if (remainder)
+				this->_operand = this->instruction("srem i32 " + left + ", " + divisor);
+			else {
+				const std::string quotient = this->instruction("sdiv i32 " + left + ", " + divisor);
+				const std::string negation = this->instruction("sub i32 0, " + left);
+				this->_operand = this->instruction("select i1 " + is_minus_one + ", i32 " + negation + ", i32 " + quotient);
+			}
+			this->_type = "i32";
+		}
+
+		void logical(const char* opcode, const binary_expr& e) {
+			const std::string left = this->build(*e.left_operand());
+			const std::string right = this->build(*e.right_operand());
+			this->_operand = this->instruction(std::string(opcode) + " i1 " + left + ", " + right);
+			this->_type = "i1";
+		}
+	};
+
+	const char* const llvm_emitter::division_by_zero_function = "calc_division_by_zero";
+
+	llvm_emitter::llvm_emitter(std::ostream& out) : _out(out) {}
+
+	void llvm_emitter::emit_prologue() {
+		this->_out << "; ModuleID = '" PACKAGE "'\n"
+		           << "; Generated by " PACKAGE_STRING ".\n"
+		           << '\n'
+		           << "declare void @" << division_by_zero_function << "() noreturn\n";
+	}
+
+	std::string llvm_emitter::emit(const expr& e, std::size_t n) {
+		const std::string name = "expr_" + std::to_string(n);
+		const char* type = static_type(e) == boolean_type::instance ? "i1" : "i32";
+
+		llvm_function_builder builder(name);
+		const std::string result = builder.build(e);
+
+		this->_out << '\n'
+		           << "define " << type << " @" << name << "() {\n"
+		           << builder.body()
+		           << '\t' << "ret " << type << ' ' << result << '\n'
+		           << "}\n";
+
+		return name;
+	}
+} // namespace calc
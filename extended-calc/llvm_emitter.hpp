@@ -0,0 +1,70 @@
+/**
+ * @file		llvm_emitter.hpp
+ * Contains type declarations for emitting LLVM intermediate representation.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_LLVM_EMITTER_HPP
+#define CALC_LLVM_EMITTER_HPP
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+#include "ast.hpp"
+
+namespace calc {
+	/**
+	 * Translates expressions into textual LLVM IR. Each expression becomes a
+	 * function named @c expr_N that takes no arguments and returns an @c i32
+	 * (integer expressions) or an @c i1 (boolean expressions).
+	 *
+	 * Logical "and" and "or" expressions evaluate both operands, as calc
+	 * does, so that division by zero in either one is reported; division by
+	 * zero calls the runtime function @c calc_division_by_zero, which must
+	 * not return.
+	 */
+	class llvm_emitter {
+	public:
+		/// The name of the runtime function called on division by zero.
+		static const char* const division_by_zero_function;
+
+		/**
+		 * Constructs an emitter that writes to an output stream.
+		 * @param out	An output stream.
+		 */
+		explicit llvm_emitter(std::ostream& out);
+
+		llvm_emitter(const llvm_emitter&) = delete;
+
+		llvm_emitter& operator=(const llvm_emitter&) = delete;
+
+		/**
+		 * Writes the module header and runtime declarations. Must be called
+		 * once before the first call to emit().
+		 */
+		void emit_prologue();
+
+		/**
+		 * Writes a function that computes the value of an expression.
+		 * @param e		An expression.
+		 * @param n		The number used to name the function.
+		 * @return		The name of the emitted function.
+		 * @throw		std::invalid_argument if an operand of @p e has the
+		 * 				wrong type, in which case nothing is written.
+		 * @throw		std::overflow_error if @p e contains a big_integer,
+		 * 				in which case nothing is written.
+		 */
+		std::string emit(const expr& e, std::size_t n);
+
+	private:
+		std::ostream& _out;
+	};
+} // namespace calc
+
+#endif // CALC_LLVM_EMITTER_HPP
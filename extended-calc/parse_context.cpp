@@ -0,0 +1,16 @@
+/**
+ * @file		parse_context.cpp
+ * Contains type definitions for parsing many small inputs.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#include "parse_context.hpp"
+
+namespace calc {
+	// Explicit instantiations for the basic_parse_context class template.
+	template class basic_parse_context<char>;
+	template class basic_parse_context<wchar_t>;
+} // namespace calc
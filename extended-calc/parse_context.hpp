@@ -0,0 +1,133 @@
+/**
+ * @file		parse_context.hpp
+ * Contains type declarations for parsing many small inputs.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_PARSE_CONTEXT_HPP
+#define CALC_PARSE_CONTEXT_HPP
+
+#include "config.hpp"
+
+#include <memory>
+
+#include "parser.hpp"
+
+namespace calc {
+	template <typename CharT, class Traits = symbol_traits<CharT>>
+	class basic_parse_context;
+
+	/// A parse context for @c char characters.
+	typedef basic_parse_context<char> parse_context;
+
+	/// A parse context for @c wchar_t characters.
+	typedef basic_parse_context<wchar_t> wparse_context;
+
+	/**
+	 * A parser that reads directly from a string view and can be reset,
+	 * for parsing many independent short inputs. Unlike a parser over a
+	 * new string stream for each input, a context keeps its stream buffer,
+	 * symbol tables, and the storage of its lexer and parser between
+	 * inputs, so that an input costs little more than its parse.
+	 * @tparam CharT	The character type.
+	 * @tparam Traits	The symbol traits type.
+	 */
+	template <typename CharT, class Traits>
+	class basic_parse_context {
+	public:
+		typedef CharT char_type;
+		typedef Traits traits_type;
+		typedef typename Traits::string_view_type string_view_type;
+		typedef typename Traits::streambuf_type streambuf_type;
+		typedef basic_parser<CharT, Traits> parser_type;
+
+		basic_parse_context() :
+			_buffer(), _parser(&this->_buffer)
+		{}
+
+		basic_parse_context(const basic_parse_context&) = delete;
+
+		basic_parse_context& operator=(const basic_parse_context&) = delete;
+
+		/**
+		 * Makes @p input the input of the parser and starts over. The
+		 * characters are not copied until they are lexed, so @p input must
+		 * outlive its parse. The end of @p input ends its last line, since
+		 * a view rarely ends in a newline.
+		 * @param input	The characters to parse.
+		 */
+		void reset(string_view_type input) noexcept {
+			this->_buffer.reset(input);
+			this->parser().reset();
+			this->parser().eof_ends_line(true);
+		}
+
+		/**
+		 * Returns the parser, for parsing every expression of an input
+		 * after reset() or for changing its settings, which persist across
+		 * inputs.
+		 * @return	The parser.
+		 */
+		parser_type& parser() noexcept {
+			return this->_parser;
+		}
+
+		const parser_type& parser() const noexcept {
+			return this->_parser;
+		}
+
+		/**
+		 * Parses the first expression of @p input, skipping empty lines.
+		 * @param input	The characters to parse.
+		 * @return		An abstract syntax tree, or null if @p input has no
+		 * 				expression.
+		 * @throw typename parser_type::error_type	If the expression has a
+		 * 											syntax error.
+		 */
+		std::unique_ptr<const expr> parse_one(string_view_type input) {
+			this->reset(input);
+			return this->parser().next_expr(true);
+		}
+
+		/**
+		 * Parses and evaluates the first expression of @p input.
+		 * @param input	The characters to parse.
+		 * @return		The value of the expression, or null if @p input has
+		 * 				no expression.
+		 * @throw typename parser_type::error_type	If the expression has a
+		 * 											syntax error.
+		 * @throw std::invalid_argument	If the operands of an operator have
+		 * 								the wrong types.
+		 * @throw std::domain_error		If the expression divides by zero.
+		 */
+		std::unique_ptr<value> evaluate_one(string_view_type input) {
+			std::unique_ptr<const expr> e = this->parse_one(input);
+			if (!e)
+				return nullptr;
+			return e->value();
+		}
+
+	private:
+		/**
+		 * A stream buffer that reads a string view in place.
+		 */
+		class view_streambuf : public streambuf_type {
+		public:
+			void reset(string_view_type input) noexcept {
+				// the get area is never written to
+				CharT* const first = const_cast<CharT*>(input.data());
+				this->setg(first, first, first + input.size());
+			}
+		};
+
+		view_streambuf _buffer;
+		parser_type _parser;
+	};
+} // namespace calc
+
+#include "parse_context.ipp"
+
+#endif // CALC_PARSE_CONTEXT_HPP
@@ -0,0 +1,21 @@
+/**
+ * @file		parse_context.ipp
+ * Contains template definitions and explicit template instantiation
+ * declarations.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_PARSE_CONTEXT_IPP
+#define CALC_PARSE_CONTEXT_IPP
+
+namespace calc {
+	// Inhibit implicit instantiations for required instantiations, which are
+	// defined via explicit instantiations elsewhere.
+	extern template class basic_parse_context<char>;
+	extern template class basic_parse_context<wchar_t>;
+} // namespace calc
+
+#endif // CALC_PARSE_CONTEXT_IPP
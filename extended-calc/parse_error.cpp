@@ -10,7 +10,10 @@
 #include "parse_error.hpp"
 
 namespace calc {
-	// Explicit instantiations for the basic_parse_error class template.
+	// Explicit instantiations for the basic_parse_diagnostic and
+	// basic_parse_error class templates.
+	template class basic_parse_diagnostic<char>;
+	template class basic_parse_diagnostic<wchar_t>;
 	template class basic_parse_error<char>;
 	template class basic_parse_error<wchar_t>;
 } // namespace calc
@@ -17,6 +17,14 @@
 #include "script.hpp"
 
 namespace calc {
+	template <typename CharT, class Traits = symbol_traits<CharT>>
+	class basic_parse_diagnostic;
+
+	/// A parsing diagnostic for @c char characters.
+	typedef basic_parse_diagnostic<char> parse_diagnostic;
+	/// A parsing diagnostic for @c wchar_t characters.
+	typedef basic_parse_diagnostic<wchar_t> wparse_diagnostic;
+
 	template <typename CharT, class Traits = symbol_traits<CharT>>
 	class basic_parse_error;
 
@@ -26,6 +34,44 @@ namespace calc {
 	/// A parsing error for @c wchar_t characters.
 	typedef basic_parse_error<wchar_t> wparse_error;
 
+	/**
+	 * Describes a parsing error without the cost of an exception object. The
+	 * message is a string literal, so recording a diagnostic allocates
+	 * nothing, and text is only produced if the diagnostic is printed.
+	 * @tparam CharT	The character type.
+	 * @tparam Traits	The symbol traits type.
+	 */
+	template <typename CharT, class Traits>
+	class basic_parse_diagnostic {
+	public:
+		typedef CharT char_type;
+		typedef Traits traits_type;
+		typedef basic_script_extent<CharT, Traits> extent_type;
+
+		constexpr basic_parse_diagnostic(error_id code,
+		                                 const extent_type& extent,
+		                                 const char* message) noexcept :
+			_code(code), _extent(extent), _message(message)
+		{}
+
+		constexpr error_id code() const noexcept {
+			return this->_code;
+		}
+
+		constexpr extent_type extent() const noexcept {
+			return this->_extent;
+		}
+
+		constexpr const char* message() const noexcept {
+			return this->_message;
+		}
+
+	private:
+		error_id _code;
+		extent_type _extent;
+		const char* _message;
+	};
+
 	/**
 	 * Defines the type of exception object thrown to report parsing errors.
 	 * @tparam CharT	The character type.
@@ -50,6 +96,10 @@ namespace calc {
 			std::runtime_error(what), _code(code), _extent(extent)
 		{}
 
+		explicit basic_parse_error(const basic_parse_diagnostic<CharT, Traits>& diagnostic) :
+			basic_parse_error(diagnostic.code(), diagnostic.extent(), diagnostic.message())
+		{}
+
 		constexpr error_id code() const noexcept {
 			return this->_code;
 		}
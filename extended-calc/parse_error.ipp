@@ -14,6 +14,8 @@
 namespace calc {
 	// Inhibit implicit instantiations for required instantiations, which are
 	// defined via explicit instantiations elsewhere.
+	extern template class basic_parse_diagnostic<char>;
+	extern template class basic_parse_diagnostic<wchar_t>;
 	extern template class basic_parse_error<char>;
 	extern template class basic_parse_error<wchar_t>;
 } // namespace calc
@@ -13,13 +13,64 @@
 #include "config.hpp"
 
 #include <cassert>
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <unordered_set>
+#include <vector>
 
+#include "instrument.hpp"
 #include "lexer.hpp"
 #include "parse_error.hpp"
+#include "token_buffer.hpp"
 #include "ast.hpp"
 
 namespace calc {
+	/**
+	 * The outcome of basic_parser::try_next_expr(), in the manner of an
+	 * @c expected: either an abstract syntax tree, which is null at the end
+	 * of the input, or a diagnostic. The diagnostic belongs to the parser
+	 * and lives as long as it does. A parser that recovers from errors
+	 * always returns a tree, with the errors in error_expr nodes.
+	 * @tparam CharT	The character type.
+	 * @tparam Traits	The symbol traits type.
+	 */
+	template <typename CharT, class Traits>
+	class basic_parse_result {
+	public:
+		typedef basic_parse_diagnostic<CharT, Traits> diagnostic_type;
+
+		basic_parse_result(std::unique_ptr<const expr> value) noexcept :
+			_value(std::move(value)), _error(nullptr)
+		{}
+
+		basic_parse_result(const diagnostic_type& error) noexcept :
+			_value(), _error(&error)
+		{}
+
+		bool has_value() const noexcept {
+			return !this->_error;
+		}
+
+		explicit operator bool() const noexcept {
+			return this->has_value();
+		}
+
+		std::unique_ptr<const expr>& value() noexcept {
+			assert(this->has_value());
+			return this->_value;
+		}
+
+		const diagnostic_type& error() const noexcept {
+			assert(!this->has_value());
+			return *this->_error;
+		}
+
+	private:
+		std::unique_ptr<const expr> _value;
+		const diagnostic_type* _error;
+	};
+
 	/**
 	 * Converts a sequence of tokens into an abstract syntax tree.
 	 * @tparam CharT	The character type.
@@ -40,13 +91,17 @@ namespace calc {
 		typedef basic_token<CharT, Traits> token_type;
 		typedef basic_lexer<CharT, Traits> lexer_type;
 		typedef basic_parse_error<CharT, Traits> error_type;
+		typedef basic_parse_diagnostic<CharT, Traits> diagnostic_type;
+		typedef basic_parse_result<CharT, Traits> result_type;
 
 		/**
 		 * Constructs a parser that reads from a stream buffer.
 		 * @param sb	Pointer to a stream buffer.
 		 */
 		explicit basic_parser(streambuf_type* sb) :
-			_lexer(sb), _tokens(), _errors()
+			_lexer(sb), _tokens(), _diagnostics(), _error(nullptr),
+			_last_errors(), _last_start_offset(0), _last_end_offset(0),
+			_recover(false), _eof_ends_line(false)
 		{}
 
 		/**
@@ -65,8 +120,97 @@ namespace calc {
 		 * 						@c false.
 		 * @return				An abstract syntax tree that represents the
 		 * 						parsed expression.
+		 * @throw error_type	If the expression has a syntax error.
+		 */
+		std::unique_ptr<const expr> next_expr(bool skip_newlines = false) {
+			result_type result = this->try_next_expr(skip_newlines);
+			if (!result)
+				throw error_type(result.error());
+			return std::move(result.value());
+		}
+
+		/**
+		 * Parses an expression like next_expr(), but reports a syntax error
+		 * by returning it rather than by throwing an exception, which makes
+		 * bad lines in dirty input as cheap as good ones.
+		 * @param skip_newlines	@c true if empty lines preceding the
+		 * 						expression should be skipped. Defaults to
+		 * 						@c false.
+		 * @return				The abstract syntax tree of the expression,
+		 * 						or the diagnostic of its first error.
+		 * 						In recovery mode, always the tree.
+		 */
+		result_type try_next_expr(bool skip_newlines = false);
+
+		/**
+		 * Returns the diagnostics of the expression that was most recently
+		 * parsed, in the order that they were found. Outside of recovery
+		 * mode, there is at most one.
+		 * @return	The syntax errors of the most recently parsed expression.
+		 */
+		const std::vector<const diagnostic_type*>& last_errors() const noexcept {
+			return this->_last_errors;
+		}
+
+		/**
+		 * Starts over on whatever the stream buffer holds now, as if the
+		 * parser were new, but keeps the storage of the lexer, the tokens,
+		 * and the diagnostics. Diagnostics of earlier expressions are
+		 * destroyed.
+		 */
+		void reset() noexcept {
+			this->lexer().reset();
+			this->tokens().clear();
+			this->_diagnostics.clear();
+			this->_error = nullptr;
+			this->_last_errors.clear();
+			this->_last_start_offset = 0;
+			this->_last_end_offset = 0;
+		}
+
+		/**
+		 * Takes back the end of the input, if the parser has reached it, so
+		 * that parsing goes on with characters that the stream buffer gets
+		 * later, as if they had been there all along.
+		 */
+		void resume() {
+			if (!this->tokens().empty() && this->eof())
+				this->unget();
+			this->lexer().resume();
+		}
+
+		/**
+		 * Returns the number of distinct syntax errors found so far.
+		 * @return	The number of distinct syntax errors.
+		 */
+		std::size_t error_count() const noexcept {
+			return this->_diagnostics.size();
+		}
+
+		/**
+		 * Returns the span of text of the expression that was most recently
+		 * returned by next_expr().
+		 * @return	The span of text of the most recently parsed expression.
+		 */
+		extent_type last_extent() const noexcept {
+			return extent_type(this->position_helper(), this->_last_start_offset, this->_last_end_offset);
+		}
+
+		/**
+		 * Returns the number of characters read from the input so far.
+		 * @return	The number of characters read from the input.
+		 */
+		std::size_t characters_read() const noexcept {
+			return this->lexer().offset();
+		}
+
+		/**
+		 * Returns the number of tokens extracted from the input so far.
+		 * @return	The number of tokens extracted from the input.
 		 */
-		std::unique_ptr<const expr> next_expr(bool skip_newlines = false);
+		std::size_t token_count() const noexcept {
+			return this->lexer().token_count();
+		}
 
 		/**
 		 * Returns the current locale associated with the parser.
@@ -85,6 +229,61 @@ namespace calc {
 			return this->lexer().imbue(loc);
 		}
 
+		/**
+		 * Returns whether the input is treated as UTF-8.
+		 * @return	@c true if the input is treated as UTF-8.
+		 */
+		bool utf8() const noexcept {
+			return this->lexer().utf8();
+		}
+
+		/**
+		 * Turns UTF-8 mode on or off.
+		 * @param enable	Whether to treat the input as UTF-8.
+		 */
+		void utf8(bool enable) noexcept {
+			this->lexer().utf8(enable);
+		}
+
+		/**
+		 * Returns whether the parser recovers from syntax errors.
+		 * @return	@c true if the parser recovers from syntax errors.
+		 */
+		bool recover() const noexcept {
+			return this->_recover;
+		}
+
+		/**
+		 * Turns recovery mode on or off. In recovery mode, a syntax error
+		 * does not end the expression: the part that is in error becomes an
+		 * error_expr, the parser resynchronizes on the next operator or
+		 * parenthesis, and goes on, so that every error in a line is found
+		 * in one pass. last_errors() lists them.
+		 * @param enable	Whether to recover from syntax errors.
+		 */
+		void recover(bool enable) noexcept {
+			this->_recover = enable;
+		}
+
+		/**
+		 * Returns whether the end of the input ends a line.
+		 * @return	@c true if the end of the input ends a line.
+		 */
+		bool eof_ends_line() const noexcept {
+			return this->_eof_ends_line;
+		}
+
+		/**
+		 * Makes the end of the input end a line, or not. If it does, the
+		 * last expression of an input needs no newline after it, and an
+		 * operand missing at the end of the input is missing at the end of
+		 * a line; otherwise, both are syntax errors at the end of the file.
+		 * @param enable	Whether the end of the input ends a line.
+		 */
+		void eof_ends_line(bool enable) noexcept {
+			this->_eof_ends_line = enable;
+		}
+
 		/**
 		 * Returns true if the associated input stream has no errors and the
 		 * parser is ready for parsing.
@@ -98,9 +297,36 @@ namespace calc {
 	private:
 		typedef basic_script_position_helper<CharT, Traits> position_helper_type;
 
+		/// Hashes a diagnostic by its code and extent, which are what make
+		/// two diagnostics the same.
+		struct diagnostic_hash {
+			std::size_t operator()(const diagnostic_type& d) const noexcept {
+				const std::size_t h = std::hash<std::size_t>()(d.extent().start_offset());
+				return (h * 31 + d.extent().end_offset()) * 31 + static_cast<std::size_t>(d.code());
+			}
+		};
+
+		struct diagnostic_equal {
+			bool operator()(const diagnostic_type& d1, const diagnostic_type& d2) const noexcept {
+				return d1.code() == d2.code() && d1.extent() == d2.extent();
+			}
+		};
+
+		typedef basic_token_buffer<CharT, Traits> token_buffer_type;
+
 		lexer_type _lexer;
-		std::list<token_type> _tokens;
-		std::list<error_type> _errors;
+		/// The tokens of the expression being parsed, and the next token.
+		token_buffer_type _tokens;
+		/// Every distinct diagnostic, whose addresses stay valid while the
+		/// set grows.
+		std::unordered_set<diagnostic_type, diagnostic_hash, diagnostic_equal> _diagnostics;
+		/// The diagnostic of the expression being parsed, if any.
+		const diagnostic_type* _error;
+		std::vector<const diagnostic_type*> _last_errors;
+		std::size_t _last_start_offset;
+		std::size_t _last_end_offset;
+		bool _recover;
+		bool _eof_ends_line;
 
 		lexer_type& lexer() noexcept {
 			return this->_lexer;
@@ -127,56 +353,47 @@ namespace calc {
 		}
 
 		std::size_t offset() const noexcept {
-			return this->peek().extent().start_offset();
+			return this->tokens().start_offset(this->peek_index());
 		}
 
 		extent_type extent_from(std::size_t start_offset) const noexcept {
 			return extent_type(this->position_helper(), start_offset, this->offset());
 		}
 
-		std::list<token_type>& tokens() noexcept {
+		token_buffer_type& tokens() noexcept {
 			return this->_tokens;
 		}
 
-		const std::list<token_type>& tokens() const noexcept {
+		const token_buffer_type& tokens() const noexcept {
 			return this->_tokens;
 		}
 
-		std::list<error_type>& errors() noexcept {
-			return this->_errors;
+		bool eof() const {
+			return this->peek_kind() == token_kind::eof;
 		}
 
-		const std::list<error_type>& errors() const noexcept {
-			return this->_errors;
+		/// Returns the index of the next token in the token buffer, which is
+		/// always the last one.
+		std::size_t peek_index() const noexcept {
+			assert(!this->tokens().empty());
+			return this->tokens().size() - 1;
 		}
 
-		bool eof() const {
-			return this->peek().kind() == token_kind::eof;
+		token_kind peek_kind() const noexcept {
+			return this->tokens().kind(this->peek_index());
 		}
 
-		token_type& get() {
-			assert(!this->eof());
-			token_type& next_token = this->peek();
-			this->tokens().push_back(this->lexer().next_token());
-			return next_token;
-		}
-
-		token_type& peek() {
-			assert(!this->tokens().empty());
+		token_type peek() const noexcept {
 			return this->tokens().back();
 		}
 
-		const token_type& peek() const {
-			assert(!this->tokens().empty());
-			return this->tokens().back();
+		void add_flags(std::size_t index, token_flags flags) noexcept {
+			this->tokens().flags(index, this->tokens().flags(index) | flags);
 		}
 
 		void unget() {
-			string_view_type next_token_text = this->peek().text();
-			for (auto itr = next_token_text.rbegin(); itr != next_token_text.rend(); ++itr)
-				this->lexer().putback(*itr);
+			this->lexer().rewind(this->offset());
 			this->tokens().pop_back();
-			this->lexer().rewind_blanks();
 		}
 
 		void ignore() {
@@ -194,9 +411,8 @@ namespace calc {
 		std::unique_ptr<const expr> parse_logical_and_expr();
 		std::unique_ptr<const expr> parse_logical_or_expr();
 
-		void report_error(const error_type& error);
-		void report_error(error_id code, const extent_type& extent, const char* message);
-		void report_error(error_id code, const extent_type& extent, const std::string& message);
+		std::unique_ptr<const expr> report_error(error_id code, const extent_type& extent, const char* message,
+		                                         std::vector<std::unique_ptr<const expr>> operands = {});
 	};
 } // namespace calc
 
@@ -15,32 +15,80 @@
 
 namespace calc {
 	template <typename CharT, class Traits>
-	std::unique_ptr<const expr>
-	basic_parser<CharT, Traits>::next_expr(bool skip_newlines) {
+	typename basic_parser<CharT, Traits>::result_type
+	basic_parser<CharT, Traits>::try_next_expr(bool skip_newlines) {
+		CALC_PHASE_SCOPE(parse);
+
+		this->_error = nullptr;
+		this->_last_errors.clear();
+
+		// the tokens of the previous expression are no longer needed
+		if (this->tokens().size() > 1) {
+			const token_type next = this->peek();
+			this->tokens().clear();
+			this->tokens().push_back(next);
+		}
+
 		// lazily extract first token from input stream
 		if (this->tokens().empty())
 			this->tokens().push_back(this->lexer().next_token());
 		// skip newline at the end of the previous expression
-		else if (this->peek().kind() == token_kind::newline)
+		else if (this->peek_kind() == token_kind::newline)
 			this->ignore();
 
 		if (skip_newlines)
-			while (!this->eof() && this->peek().kind() == token_kind::newline)
+			while (!this->eof() && this->peek_kind() == token_kind::newline)
 				this->ignore();
 
 		if (this->eof())
 			return std::unique_ptr<const expr>();
 
 		// check whether newline follows expression
+		const std::size_t start_offset = this->offset();
 		std::unique_ptr<const expr> result = this->parse_expr();
-		token_type& token = this->peek();
+		if (!result)
+			return *this->_error;
+		const token_type token = this->peek();
+		const std::size_t index = this->peek_index();
+
+		if (this->recover() && token.kind() != token_kind::newline && !this->eof()) {
+			// parse what follows the expression as more expressions, which
+			// become the operands of an error, along with the first one
+			std::vector<std::unique_ptr<const expr>> operands;
+			operands.push_back(std::move(result));
+			const std::size_t error_start_offset = token.extent().start_offset();
+			const std::size_t error_end_offset = token.extent().end_offset();
+
+			while (!this->eof() && this->peek_kind() != token_kind::newline) {
+				const token_type next = this->peek();
+				if (next.kind() == token_kind::right_parenthesis) {
+					// unless it was already reported as a missing operand
+					if (next)
+						this->report_error(error_id::unexpected_token, next.extent(), "Unexpected token.");
+					this->add_flags(this->peek_index(), token_flags::has_error);
+					this->ignore();
+				}
+				else {
+					this->add_flags(this->peek_index(), token_flags::has_error);
+					this->report_error(error_id::unexpected_token, next.extent(), "Expected newline before expression.");
+					operands.push_back(this->parse_expr());
+				}
+			}
+
+			result = std::make_unique<error_expr>(error_id::unexpected_token, error_start_offset, error_end_offset, std::move(operands));
+		}
 
-		if (token.kind() != token_kind::newline) {
+		this->_last_start_offset = start_offset;
+		this->_last_end_offset = this->tokens().size() > 1 ? std::max(start_offset, this->tokens().end_offset(this->peek_index() - 1)) : start_offset;
+
+		if (this->peek_kind() != token_kind::newline && !(this->eof_ends_line() && this->eof())
+		    && !this->recover()) {
 			// skip the rest of the tokens in this line
-			while (!this->eof() && this->peek().kind() != token_kind::newline)
+			while (!this->eof() && this->peek_kind() != token_kind::newline)
 				this->ignore();
-			token.flags(token.flags() | token_flags::has_error);
+			this->add_flags(index, token_flags::has_error);
 			this->report_error(error_id::unexpected_token, this->extent_from(token.extent().start_offset()), "Expected newline before expression.");
+			return *this->_error;
 		}
 
 		return std::move(result);
@@ -55,7 +103,8 @@ namespace calc {
 	std::unique_ptr<const expr>
 	basic_parser<CharT, Traits>::parse_primary_expr() {
 		std::unique_ptr<const expr> result = nullptr;
-		token_type& token = this->peek();
+		const token_type token = this->peek();
+		const std::size_t index = this->peek_index();
 
 		switch (token.kind()) {
 			case token_kind::boolean:
@@ -64,42 +113,55 @@ namespace calc {
 				break;
 			case token_kind::integer:
 				try {
-					result = std::make_unique<integer>(this->traits().int32_value(token.text().to_string()));
+					result = std::make_unique<integer>(this->traits().int_value(token.text()));
 					this->ignore();
 				}
 				catch (const std::out_of_range& exception) {
 					this->ignore();
-					token.flags(token.flags() | token_flags::has_error);
-					this->report_error(error_id::integer_out_of_range, token.extent(), "Integer literal is outside the range of -(2^31) to 2^31 - 1.");
+#if ENABLE_BIGINT
+					result = std::make_unique<big_integer>(this->traits().big_int_value(token.text()));
+#else
+					this->add_flags(index, token_flags::has_error);
+					result = this->report_error(error_id::integer_out_of_range, token.extent(), default_integer_policy::range_message());
+#endif
 				}
 				break;
 			case token_kind::left_parenthesis:
 				this->ignore();
 				result = this->parse_expr();
-				if (this->peek().kind() == token_kind::right_parenthesis)
+				if (!result)
+					return nullptr;
+				if (this->peek_kind() == token_kind::right_parenthesis)
 					this->ignore();
 				else {
-					token.flags(token.flags() | token_flags::has_error);
-					this->report_error(error_id::missing_end_parenthesis, this->extent_from(token.extent().start_offset()), "Expression in parentheses is missing ')'.");
+					this->add_flags(index, token_flags::has_error);
+					std::vector<std::unique_ptr<const expr>> operands;
+					operands.push_back(std::move(result));
+					result = this->report_error(error_id::missing_end_parenthesis, this->extent_from(token.extent().start_offset()), "Expression in parentheses is missing ')'.", std::move(operands));
 				}
 				break;
 			case token_kind::eof:
-				token.flags(token.flags() | token_flags::has_error);
-				this->report_error(error_id::unexpected_token, token.extent(), "Unexpected end of file.");
+				this->add_flags(index, token_flags::has_error);
+				result = this->report_error(error_id::unexpected_token, token.extent(),
+				                            this->eof_ends_line() ? "Unexpected end of line." : "Unexpected end of file.");
 				break;
 			case token_kind::newline:
-				token.flags(token.flags() | token_flags::has_error);
-				this->report_error(error_id::unexpected_token, token.extent(), "Unexpected end of line.");
+				this->add_flags(index, token_flags::has_error);
+				result = this->report_error(error_id::unexpected_token, token.extent(), "Unexpected end of line.");
 				break;
 			case token_kind::unknown:
 				this->ignore();
-				token.flags(token.flags() | token_flags::has_error);
-				this->report_error(error_id::unknown_token, token.extent(), "Unrecognized token.");
+				this->add_flags(index, token_flags::has_error);
+				result = this->report_error(error_id::unknown_token, token.extent(), "Unrecognized token.");
 				break;
 			default:
-				this->ignore();
-				token.flags(token.flags() | token_flags::has_error);
-				this->report_error(error_id::unexpected_token, token.extent(), "Unexpected token.");
+				// when recovering, leave an operator to the production that
+				// it belongs to, as if only its left operand were missing;
+				// a stray ')' is left to the enclosing parentheses
+				if (!this->recover())
+					this->ignore();
+				this->add_flags(index, token_flags::has_error);
+				result = this->report_error(error_id::unexpected_token, token.extent(), "Unexpected token.");
 				break;
 		}
 
@@ -110,24 +172,34 @@ namespace calc {
 	std::unique_ptr<const expr>
 	basic_parser<CharT, Traits>::parse_unary_expr() {
 		std::unique_ptr<const expr> result = nullptr;
-		token_type& token = this->peek();
+		std::unique_ptr<const expr> operand = nullptr;
+		const std::size_t index = this->peek_index();
 
-		switch (token.kind()) {
+		switch (this->tokens().kind(index)) {
 			case token_kind::positive_or_addition_operator:
 				// set token flags for unary plus operator
-				token.flags((token.flags() & ~(token_flags::operator_associativity_mask | token_flags::binary_operator_mask)) | token_flags::right_associative);
+				this->tokens().flags(index, (this->tokens().flags(index) & ~(token_flags::operator_associativity_mask | token_flags::binary_operator_mask)) | token_flags::right_associative);
 				this->ignore();
-				result = std::make_unique<positive_expr>(this->parse_unary_expr());
+				operand = this->parse_unary_expr();
+				if (!operand)
+					return nullptr;
+				result = std::make_unique<positive_expr>(std::move(operand));
 				break;
 			case token_kind::negative_or_subtraction_operator:
 				// set token flags for unary negation operator
-				token.flags((token.flags() & ~(token_flags::operator_associativity_mask | token_flags::binary_operator_mask)) | token_flags::right_associative);
+				this->tokens().flags(index, (this->tokens().flags(index) & ~(token_flags::operator_associativity_mask | token_flags::binary_operator_mask)) | token_flags::right_associative);
 				this->ignore();
-				result = std::make_unique<negative_expr>(this->parse_unary_expr());
+				operand = this->parse_unary_expr();
+				if (!operand)
+					return nullptr;
+				result = std::make_unique<negative_expr>(std::move(operand));
 				break;
 			case token_kind::logical_not_operator:
 				this->ignore();
-				result = std::make_unique<logical_not_expr>(this->parse_unary_expr());
+				operand = this->parse_unary_expr();
+				if (!operand)
+					return nullptr;
+				result = std::make_unique<logical_not_expr>(std::move(operand));
 				break;
 			default:
 				result = this->parse_primary_expr();
@@ -141,25 +213,33 @@ namespace calc {
 	std::unique_ptr<const expr>
 	basic_parser<CharT, Traits>::parse_multiplicative_expr() {
 		std::unique_ptr<const expr> result = this->parse_unary_expr();
+		if (!result)
+			return nullptr;
 
 		while (!this->eof()) {
 			std::unique_ptr<const expr> rest = nullptr;
-			token_type& token = this->peek();
+			const std::size_t index = this->peek_index();
 
-			switch (token.kind()) {
+			switch (this->tokens().kind(index)) {
 				case token_kind::multiplication_operator:
 					this->ignore();
 					rest = this->parse_unary_expr();
+					if (!rest)
+						return nullptr;
 					result = std::make_unique<multiplication_expr>(std::move(result), std::move(rest));
 					break;
 				case token_kind::division_operator:
 					this->ignore();
 					rest = this->parse_unary_expr();
+					if (!rest)
+						return nullptr;
 					result = std::make_unique<division_expr>(std::move(result), std::move(rest));
 					break;
 				case token_kind::modulus_operator:
 					this->ignore();
 					rest = this->parse_unary_expr();
+					if (!rest)
+						return nullptr;
 					result = std::make_unique<modulus_expr>(std::move(result), std::move(rest));
 					break;
 				default:
@@ -175,24 +255,30 @@ namespace calc {
 	std::unique_ptr<const expr>
 	basic_parser<CharT, Traits>::parse_additive_expr() {
 		std::unique_ptr<const expr> result = this->parse_multiplicative_expr();
+		if (!result)
+			return nullptr;
 
 		while (!this->eof()) {
 			std::unique_ptr<const expr> rest = nullptr;
-			token_type& token = this->peek();
+			const std::size_t index = this->peek_index();
 
-			switch (token.kind()) {
+			switch (this->tokens().kind(index)) {
 				case token_kind::positive_or_addition_operator:
 					// set token flags for binary addition operator
-					token.flags((token.flags() & ~(token_flags::operator_associativity_mask | token_flags::unary_operator_mask)) | token_flags::left_associative);
+					this->tokens().flags(index, (this->tokens().flags(index) & ~(token_flags::operator_associativity_mask | token_flags::unary_operator_mask)) | token_flags::left_associative);
 					this->ignore();
 					rest = this->parse_multiplicative_expr();
+					if (!rest)
+						return nullptr;
 					result = std::make_unique<addition_expr>(std::move(result), std::move(rest));
 					break;
 				case token_kind::negative_or_subtraction_operator:
 					// set token flags for binary subtraction operator
-					token.flags((token.flags() & ~(token_flags::operator_associativity_mask | token_flags::unary_operator_mask)) | token_flags::left_associative);
+					this->tokens().flags(index, (this->tokens().flags(index) & ~(token_flags::operator_associativity_mask | token_flags::unary_operator_mask)) | token_flags::left_associative);
 					this->ignore();
 					rest = this->parse_multiplicative_expr();
+					if (!rest)
+						return nullptr;
 					result = std::make_unique<subtraction_expr>(std::move(result), std::move(rest));
 					break;
 				default:
@@ -208,30 +294,40 @@ namespace calc {
 	std::unique_ptr<const expr>
 	basic_parser<CharT, Traits>::parse_ordering_expr() {
 		std::unique_ptr<const expr> result = this->parse_additive_expr();
+		if (!result)
+			return nullptr;
 
 		while (!this->eof()) {
 			std::unique_ptr<const expr> rest = nullptr;
-			token_type& token = this->peek();
+			const std::size_t index = this->peek_index();
 
-			switch (token.kind()) {
+			switch (this->tokens().kind(index)) {
 				case token_kind::less_operator:
 					this->ignore();
 					rest = this->parse_additive_expr();
+					if (!rest)
+						return nullptr;
 					result = std::make_unique<less_expr>(std::move(result), std::move(rest));
 					break;
 				case token_kind::greater_operator:
 					this->ignore();
 					rest = this->parse_additive_expr();
+					if (!rest)
+						return nullptr;
 					result = std::make_unique<greater_expr>(std::move(result), std::move(rest));
 					break;
 				case token_kind::less_equal_operator:
 					this->ignore();
 					rest = this->parse_additive_expr();
+					if (!rest)
+						return nullptr;
 					result = std::make_unique<less_equal_expr>(std::move(result), std::move(rest));
 					break;
 				case token_kind::greater_equal_operator:
 					this->ignore();
 					rest = this->parse_additive_expr();
+					if (!rest)
+						return nullptr;
 					result = std::make_unique<greater_equal_expr>(std::move(result), std::move(rest));
 					break;
 				default:
@@ -247,20 +343,26 @@ namespace calc {
 	std::unique_ptr<const expr>
 	basic_parser<CharT, Traits>::parse_equality_expr() {
 		std::unique_ptr<const expr> result = this->parse_ordering_expr();
+		if (!result)
+			return nullptr;
 
 		while (!this->eof()) {
 			std::unique_ptr<const expr> rest = nullptr;
-			token_type& token = this->peek();
+			const std::size_t index = this->peek_index();
 
-			switch (token.kind()) {
+			switch (this->tokens().kind(index)) {
 				case token_kind::equal_operator:
 					this->ignore();
 					rest = this->parse_ordering_expr();
+					if (!rest)
+						return nullptr;
 					result = std::make_unique<equal_expr>(std::move(result), std::move(rest));
 					break;
 				case token_kind::not_equal_operator:
 					this->ignore();
 					rest = this->parse_ordering_expr();
+					if (!rest)
+						return nullptr;
 					result = std::make_unique<not_equal_expr>(std::move(result), std::move(rest));
 					break;
 				default:
@@ -276,15 +378,19 @@ namespace calc {
 	std::unique_ptr<const expr>
 	basic_parser<CharT, Traits>::parse_logical_and_expr() {
 		std::unique_ptr<const expr> result = this->parse_equality_expr();
+		if (!result)
+			return nullptr;
 
 		while (!this->eof()) {
 			std::unique_ptr<const expr> rest = nullptr;
-			token_type& token = this->peek();
+			const std::size_t index = this->peek_index();
 
-			switch (token.kind()) {
+			switch (this->tokens().kind(index)) {
 				case token_kind::logical_and_operator:
 					this->ignore();
 					rest = this->parse_equality_expr();
+					if (!rest)
+						return nullptr;
 					result = std::make_unique<logical_and_expr>(std::move(result), std::move(rest));
 					break;
 				default:
@@ -300,15 +406,19 @@ namespace calc {
 	std::unique_ptr<const expr>
 	basic_parser<CharT, Traits>::parse_logical_or_expr() {
 		std::unique_ptr<const expr> result = this->parse_logical_and_expr();
+		if (!result)
+			return nullptr;
 
 		while (!this->eof()) {
 			std::unique_ptr<const expr> rest = nullptr;
-			token_type& token = this->peek();
+			const std::size_t index = this->peek_index();
 
-			switch (token.kind()) {
+			switch (this->tokens().kind(index)) {
 				case token_kind::logical_or_operator:
 					this->ignore();
 					rest = this->parse_logical_and_expr();
+					if (!rest)
+						return nullptr;
 					result = std::make_unique<logical_or_expr>(std::move(result), std::move(rest));
 					break;
 				default:
@@ -321,33 +431,20 @@ namespace calc {
 	}
 
 	template <typename CharT, class Traits>
-	void
-	basic_parser<CharT, Traits>::report_error(const typename basic_parser<CharT, Traits>::error_type& error) {
-		auto error_equal = [&error] (const error_type& i) {
-			return i.code() == error.code() && i.extent() == error.extent();
-		};
-		if (std::none_of(this->errors().cbegin(), this->errors().cend(), error_equal)) {
-			this->errors().push_back(error);
-			throw error;
-		}
-	}
-
-	template <typename CharT, class Traits>
-	void
-	basic_parser<CharT, Traits>::report_error(error_id code,
-	  const typename basic_parser<CharT, Traits>::extent_type& extent,
-	  const char* message)
-	{
-		this->report_error(error_type(code, extent, message));
-	}
-
-	template <typename CharT, class Traits>
-	void
+	std::unique_ptr<const expr>
 	basic_parser<CharT, Traits>::report_error(error_id code,
 	  const typename basic_parser<CharT, Traits>::extent_type& extent,
-	  const std::string& message)
+	  const char* message, std::vector<std::unique_ptr<const expr>> operands)
 	{
-		this->report_error(error_type(code, extent, message));
+		// an error that was found before is recorded only once
+		this->_error = &*this->_diagnostics.emplace(code, extent, message).first;
+		this->_last_errors.push_back(this->_error);
+
+		// the placeholder for the erroneous part of the expression, or null
+		// to end the parse
+		if (!this->recover())
+			return nullptr;
+		return std::make_unique<error_expr>(code, extent.start_offset(), extent.end_offset(), std::move(operands));
 	}
 
 	// Inhibit implicit instantiations for required instantiations, which are
@@ -21,6 +21,15 @@ namespace calc {
 
 	/// A parser of @c wchar_t characters.
 	typedef basic_parser<wchar_t> wparser;
+
+	template <typename CharT, class Traits = symbol_traits<CharT>>
+	class basic_parse_result;
+
+	/// The result of parsing @c char characters.
+	typedef basic_parse_result<char> parse_result;
+
+	/// The result of parsing @c wchar_t characters.
+	typedef basic_parse_result<wchar_t> wparse_result;
 } // namespace calc
 
 #endif // CALC_PARSER_FWD_HPP
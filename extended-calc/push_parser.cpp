@@ -0,0 +1,16 @@
+/**
+ * @file		push_parser.cpp
+ * Contains type definitions for parsing input that arrives in chunks.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#include "push_parser.hpp"
+
+namespace calc {
+	// Explicit instantiations for the basic_push_parser class template.
+	template class basic_push_parser<char>;
+	template class basic_push_parser<wchar_t>;
+} // namespace calc
@@ -0,0 +1,129 @@
+/**
+ * @file		push_parser.hpp
+ * Contains type declarations for parsing input that arrives in chunks.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_PUSH_PARSER_HPP
+#define CALC_PUSH_PARSER_HPP
+
+#include "config.hpp"
+
+#include <cstddef>
+
+#include "parser.hpp"
+
+namespace calc {
+	template <typename CharT, class Traits = symbol_traits<CharT>>
+	class basic_push_parser;
+
+	/// A push parser of @c char characters.
+	typedef basic_push_parser<char> push_parser;
+
+	/// A push parser of @c wchar_t characters.
+	typedef basic_push_parser<wchar_t> wpush_parser;
+
+	/**
+	 * A parser that is given its input in chunks of any size, as they
+	 * arrive, instead of reading it from a stream, so that it never blocks.
+	 * Expressions are parsed a line at a time: the parser only sees lines
+	 * that are complete, that is, end in a line feed or a carriage return
+	 * as the lexer's newlines do, so that tokens split across chunks are
+	 * never lexed in part. finish() supplies the last line. Script
+	 * positions are counted from the first chunk.
+	 * @tparam CharT	The character type.
+	 * @tparam Traits	The symbol traits type.
+	 */
+	template <typename CharT, class Traits>
+	class basic_push_parser {
+	public:
+		typedef CharT char_type;
+		typedef Traits traits_type;
+		typedef typename Traits::string_type string_type;
+		typedef typename Traits::streambuf_type streambuf_type;
+		typedef basic_parser<CharT, Traits> parser_type;
+		typedef typename parser_type::result_type result_type;
+
+		basic_push_parser() :
+			_buffer(), _parser(&this->_buffer), _finished(false)
+		{}
+
+		basic_push_parser(const basic_push_parser&) = delete;
+
+		basic_push_parser& operator=(const basic_push_parser&) = delete;
+
+		/**
+		 * Appends a chunk of input. The expressions of every line that the
+		 * chunk completes can then be taken with try_next_expr().
+		 * @param s		The characters of the chunk.
+		 * @param n		The number of characters in the chunk.
+		 */
+		void feed(const CharT* s, std::size_t n);
+
+		/**
+		 * Signals the end of the input, which completes the last line even
+		 * if it does not end in a newline.
+		 */
+		void finish();
+
+		/**
+		 * Returns whether finish() was called.
+		 * @return	@c true if the end of the input was signaled.
+		 */
+		bool finished() const noexcept {
+			return this->_finished;
+		}
+
+		/**
+		 * Parses the next expression of the complete lines, skipping empty
+		 * lines, as basic_parser::try_next_expr() does.
+		 * @return	The abstract syntax tree of the expression or the
+		 * 			diagnostic of its first error; a null tree if no line is
+		 * 			complete yet, or, once finished, at the end of the input.
+		 */
+		result_type try_next_expr() {
+			return this->parser().try_next_expr(true);
+		}
+
+		/**
+		 * Returns the underlying parser, for its settings and statistics.
+		 * @return	The parser.
+		 */
+		parser_type& parser() noexcept {
+			return this->_parser;
+		}
+
+		const parser_type& parser() const noexcept {
+			return this->_parser;
+		}
+
+	private:
+		/**
+		 * A stream buffer whose get area ends at the end of the last
+		 * complete line. Characters before the get area have been taken by
+		 * the lexer, which keeps its own copy, and are discarded.
+		 */
+		class line_streambuf : public streambuf_type {
+		public:
+			/**
+			 * Appends characters, and makes every complete line, or with
+			 * @p all, every character, available.
+			 */
+			void append(const CharT* s, std::size_t n, bool all);
+
+		private:
+			string_type _data;
+		};
+
+		line_streambuf _buffer;
+		parser_type _parser;
+		bool _finished;
+	};
+} // namespace calc
+
+#include "push_parser.ipp"
+
+#endif // CALC_PUSH_PARSER_HPP
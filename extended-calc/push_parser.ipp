@@ -0,0 +1,69 @@
+/**
+ * @file		push_parser.ipp
+ * Contains template definitions and explicit template instantiation
+ * declarations.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_PUSH_PARSER_IPP
+#define CALC_PUSH_PARSER_IPP
+
+#include <stdexcept>
+
+namespace calc {
+	template <typename CharT, class Traits>
+	void
+	basic_push_parser<CharT, Traits>::line_streambuf::append(const CharT* s, std::size_t n, bool all) {
+		const std::size_t taken = this->gptr() - this->eback();
+		const std::size_t available = this->egptr() - this->gptr();
+
+		this->_data.erase(0, taken);
+		const std::size_t old_size = this->_data.size();
+		if (n > 0)
+			this->_data.append(s, n);
+
+		// only the new characters can complete a line, which ends in a
+		// line feed or carriage return, as for the lexer; the line feed of
+		// a CR LF that is split across chunks lexes as an empty line
+		std::size_t end = available;
+		if (all)
+			end = this->_data.size();
+		else
+			for (std::size_t i = this->_data.size(); i > old_size; i--)
+				if (Traits::eq(this->_data[i - 1], CharT('\n'))
+				    || Traits::eq(this->_data[i - 1], CharT('\r'))) {
+					end = i;
+					break;
+				}
+
+		CharT* const first = &this->_data[0];
+		this->setg(first, first, first + end);
+	}
+
+	template <typename CharT, class Traits>
+	void
+	basic_push_parser<CharT, Traits>::feed(const CharT* s, std::size_t n) {
+		if (this->finished())
+			throw std::logic_error("calc::basic_push_parser::feed");
+		this->_buffer.append(s, n, false);
+		this->parser().resume();
+	}
+
+	template <typename CharT, class Traits>
+	void
+	basic_push_parser<CharT, Traits>::finish() {
+		this->_finished = true;
+		this->_buffer.append(nullptr, 0, true);
+		this->parser().resume();
+	}
+
+	// Inhibit implicit instantiations for required instantiations, which are
+	// defined via explicit instantiations elsewhere.
+	extern template class basic_push_parser<char>;
+	extern template class basic_push_parser<wchar_t>;
+} // namespace calc
+
+#endif // CALC_PUSH_PARSER_IPP
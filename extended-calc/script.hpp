@@ -12,7 +12,9 @@
 
 #include "config.hpp"
 
+#include <algorithm>
 #include <ostream>
+#include <utility>
 #include <vector>
 
 #include "lexer_fwd.hpp"
@@ -47,6 +49,18 @@ namespace calc {
 	/// A script extent for @c wchar_t characters.
 	typedef basic_script_extent<wchar_t> wscript_extent;
 
+	/// The line and column numbers of a point in a script.
+	struct script_location {
+		std::size_t line_number;
+		std::size_t column_number;
+	};
+
+	/// The line and column numbers of both ends of a span of text.
+	struct script_extent_location {
+		script_location start;
+		script_location end;
+	};
+
 	/**
 	 * A helper class template for the basic_script_position and
 	 * basic_script_extent class templates.
@@ -67,15 +81,42 @@ namespace calc {
 			return this->_script;
 		}
 
+		/**
+		 * Returns whether column numbers count UTF-8 code points rather
+		 * than characters.
+		 * @return	@c true if the script is UTF-8.
+		 */
+		bool utf8() const noexcept {
+			return this->_utf8;
+		}
+
 		std::size_t get_line_number(std::size_t offset) const;
 		std::size_t get_column_number(std::size_t offset) const;
 		string_view_type get_line(std::size_t line) const;
 
+		/**
+		 * Resolves many offsets at once: sorts them, then finds their lines
+		 * and columns in one sweep over the script instead of one binary
+		 * search each.
+		 * @param offsets	Pairs of an offset and the index in @p out of its
+		 * 					location; sorted by the call.
+		 * @param out		The locations, indexed by the second member of
+		 * 					each pair.
+		 */
+		void get_locations(std::vector<std::pair<std::size_t, std::size_t>>& offsets,
+		                   std::vector<script_location>& out) const;
+
 	private:
 		string_type _script;
 		std::vector<std::size_t> _line_start_map;
-
-		basic_script_position_helper() : _script(), _line_start_map({0}) {
+		bool _utf8;
+		/// The line number found by the last lookup, which is usually near
+		/// the next one.
+		mutable std::size_t _last_line_number;
+
+		basic_script_position_helper() :
+			_script(), _line_start_map({0}), _utf8(false), _last_line_number(1)
+		{
 			// set initial capacity of script
 			this->_script.reserve(31);
 		}
@@ -91,6 +132,23 @@ namespace calc {
 		void add_line_start(std::size_t offset) {
 			this->_line_start_map.push_back(offset);
 		}
+
+		/// Forgets the script, but keeps its storage.
+		void clear() noexcept {
+			this->_script.clear();
+			this->_line_start_map.resize(1);
+			this->_last_line_number = 1;
+		}
+
+		void remove_line_starts_after(std::size_t offset) {
+			while (this->_line_start_map.size() > 1 && this->_line_start_map.back() > offset)
+				this->_line_start_map.pop_back();
+			this->_last_line_number = std::min(this->_last_line_number, this->_line_start_map.size());
+		}
+
+		void utf8(bool enable) noexcept {
+			this->_utf8 = enable;
+		}
 	};
 
 	template <typename CharT, class Traits>
@@ -191,6 +249,7 @@ namespace calc {
 	class basic_script_extent {
 		friend class basic_lexer<CharT, Traits>;
 		friend class basic_parser<CharT, Traits>;
+		friend class basic_token_buffer<CharT, Traits>;
 
 		template <typename CharT2, class Traits2>
 		friend bool
@@ -236,6 +295,18 @@ namespace calc {
 
 		string_view_type text() const;
 
+		/**
+		 * Returns the line and column numbers of both ends of each extent in
+		 * the range [@p first, @p last), in the same order. This is much
+		 * faster than querying the extents one by one when there are many.
+		 * All of the extents must belong to the same script.
+		 * @param first	The beginning of a range of extents.
+		 * @param last	The end of the range.
+		 * @return		The locations of the extents.
+		 */
+		template <class InputIt>
+		static std::vector<script_extent_location> resolve(InputIt first, InputIt last);
+
 	private:
 		const position_helper_type& _position_helper;
 		std::size_t _start_offset;
@@ -12,20 +12,85 @@
 #define CALC_SCRIPT_IPP
 
 #include <algorithm>
+#include <cassert>
 #include <iterator>
 
 namespace calc {
 	template <typename CharT, class Traits>
 	std::size_t
 	basic_script_position_helper<CharT, Traits>::get_line_number(std::size_t offset) const {
-		std::vector<std::size_t>::const_iterator i = std::upper_bound(this->line_start_map().cbegin(), this->line_start_map().cend(), offset);
-		return std::distance(this->line_start_map().cbegin(), i);
+		const std::vector<std::size_t>& map = this->line_start_map();
+
+		// diagnostics tend to be formatted in the order of the script, so
+		// the line of the last lookup, or the one after it, is likely
+		const std::size_t line = this->_last_line_number;
+		if (map[line - 1] <= offset) {
+			if (line == map.size() || offset < map[line])
+				return line;
+			if (line + 1 == map.size() || offset < map[line + 1])
+				return this->_last_line_number = line + 1;
+		}
+
+		std::vector<std::size_t>::const_iterator i = std::upper_bound(map.cbegin(), map.cend(), offset);
+		return this->_last_line_number = std::distance(map.cbegin(), i);
 	}
 
 	template <typename CharT, class Traits>
 	std::size_t
 	basic_script_position_helper<CharT, Traits>::get_column_number(std::size_t offset) const {
-		return offset - this->line_start_map()[this->get_line_number(offset) - 1] + 1;
+		const std::size_t line_start = this->line_start_map()[this->get_line_number(offset) - 1];
+
+		if (!this->utf8())
+			return offset - line_start + 1;
+
+		// columns are only needed for diagnostics, so rather than keeping
+		// a map of code points, count the bytes of the line that do not
+		// continue a multibyte sequence
+		const std::size_t end = std::min(offset, this->script().size());
+		std::size_t column = 1 + (offset - end);
+		for (std::size_t i = line_start; i < end; i++)
+			if ((static_cast<unsigned char>(this->script()[i]) & 0xc0) != 0x80)
+				column++;
+		return column;
+	}
+
+	template <typename CharT, class Traits>
+	void
+	basic_script_position_helper<CharT, Traits>::get_locations(std::vector<std::pair<std::size_t, std::size_t>>& offsets,
+	                                                           std::vector<script_location>& out) const
+	{
+		std::sort(offsets.begin(), offsets.end());
+
+		const std::vector<std::size_t>& map = this->line_start_map();
+		std::size_t line = 1;
+		// in UTF-8 mode, code points are counted from the previous offset
+		// on the same line rather than from the start of the line
+		std::size_t count_offset = 0;
+		std::size_t count = 0;
+
+		for (const std::pair<std::size_t, std::size_t>& i : offsets) {
+			const std::size_t offset = i.first;
+			const std::size_t previous_line = line;
+			while (line < map.size() && map[line] <= offset)
+				line++;
+
+			const std::size_t line_start = map[line - 1];
+			std::size_t column = offset - line_start + 1;
+			if (this->utf8()) {
+				if (line != previous_line) {
+					count_offset = line_start;
+					count = 0;
+				}
+				const std::size_t end = std::min(offset, this->script().size());
+				for (; count_offset < end; count_offset++)
+					if ((static_cast<unsigned char>(this->script()[count_offset]) & 0xc0) != 0x80)
+						count++;
+				column = 1 + count + (offset - end);
+			}
+
+			out[i.second].line_number = line;
+			out[i.second].column_number = column;
+		}
 	}
 
 	template <typename CharT, class Traits>
@@ -105,6 +170,33 @@ namespace calc {
 		return script_view.substr(this->start_offset(), this->end_offset() - this->start_offset());
 	}
 
+	template <typename CharT, class Traits>
+	template <class InputIt>
+	std::vector<script_extent_location>
+	basic_script_extent<CharT, Traits>::resolve(InputIt first, InputIt last) {
+		std::vector<std::pair<std::size_t, std::size_t>> offsets;
+		const position_helper_type* position_helper = nullptr;
+
+		// both ends of extent n resolve into slots 2n and 2n + 1
+		for (; first != last; ++first) {
+			const basic_script_extent& extent = *first;
+			assert(!position_helper || *position_helper == extent.position_helper());
+			position_helper = &extent.position_helper();
+			offsets.emplace_back(extent.start_offset(), offsets.size());
+			offsets.emplace_back(extent.end_offset(), offsets.size());
+		}
+
+		std::vector<script_location> locations(offsets.size());
+		if (position_helper)
+			position_helper->get_locations(offsets, locations);
+
+		std::vector<script_extent_location> result;
+		result.reserve(locations.size() / 2);
+		for (std::size_t i = 0; i < locations.size(); i += 2)
+			result.push_back({locations[i], locations[i + 1]});
+		return result;
+	}
+
 	template <typename CharT, class Traits, class STraits>
 	std::basic_ostream<CharT, STraits>&
 	operator<<(std::basic_ostream<CharT, STraits>& out,
@@ -30,7 +30,10 @@ namespace calc {
 		{token_kind::right_parenthesis, ")"}
 	};
 
-	// Explicit instantiations for the symbol_traits class template.
+	// Explicit instantiations for the basic_symbol_table and symbol_traits
+	// class templates.
+	template struct basic_symbol_table<char>;
+	template struct basic_symbol_table<wchar_t>;
 	template class symbol_traits<char>;
 	template class symbol_traits<wchar_t>;
 } // namespace calc
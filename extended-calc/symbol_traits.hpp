@@ -16,10 +16,16 @@
 #include <iosfwd>
 #include <locale>
 #include <map>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 #include <experimental/string_view>
 
+#include "bigint.hpp"
+#include "char_class.hpp"
 #include "constants.hpp"
+#include "integer_policy.hpp"
 #include "numeric_conversions.hpp"
 
 namespace calc {
@@ -34,6 +40,40 @@ namespace calc {
 		static const std::map<token_kind, std::string> operator_table;
 	};
 
+	/**
+	 * The strings and facets that symbol_traits derives from a locale. A
+	 * table never changes after it is built, so any number of lexers, in any
+	 * number of threads, can share it.
+	 * @tparam CharT	The character type.
+	 */
+	template <typename CharT>
+	struct basic_symbol_table {
+		typedef std::basic_string<CharT> string_type;
+
+		std::locale locale;
+		/// The ctype facet of @c locale, which @c locale keeps alive.
+		const std::ctype<CharT>* ctype;
+		/// Whether characters are classified by classic_chars rather than
+		/// by @c ctype, which is only the case for @c char in a locale with
+		/// the classic ctype facet.
+		bool classic;
+		/// Whether the locale encodes @c char strings in UTF-8.
+		bool utf8;
+		CharT carriage_return;
+		CharT line_feed;
+		CharT space;
+		CharT tab;
+		string_type newlines[3];
+		string_type true_name;
+		string_type false_name;
+		std::map<token_kind, string_type> operator_table;
+		/// The entries of @c operator_table, longest operator first, so that
+		/// the first operator that matches is also the longest.
+		std::vector<std::pair<token_kind, string_type>> operators;
+
+		explicit basic_symbol_table(const std::locale& loc);
+	};
+
 	/**
 	 * The type trait template symbol_traits supplies basic_lexer and
 	 * basic_parser with the set of types and functions necessary to operate
@@ -52,6 +92,7 @@ namespace calc {
 		typedef std::basic_istream<CharT> istream_type;
 		typedef std::basic_ostream<CharT> ostream_type;
 		typedef std::locale locale_type;
+		typedef basic_symbol_table<CharT> table_type;
 
 		static constexpr std::size_t npos = std::size_t(-1);
 
@@ -71,75 +112,149 @@ namespace calc {
 			return char_traits_type::eq_int_type(c, char_traits_type::eof());
 		}
 
-		symbol_traits() {
-			this->init();
+		symbol_traits() :
+			_table(shared_table(locale_type()))
+		{
+			this->utf8(this->_table->utf8);
 		}
 
 		locale_type getloc() const {
-			return this->_locale;
+			return this->_table->locale;
 		}
 
 		locale_type imbue(const locale_type& loc) {
-			locale_type temp(this->_locale);
-			this->_locale = loc;
-			this->init(); // reinitialize cached strings
+			locale_type temp(this->_table->locale);
+			this->_table = shared_table(loc);
+			this->utf8(this->_table->utf8);
 			return temp;
 		}
 
+		/**
+		 * Returns whether strings are treated as UTF-8. In UTF-8 mode only
+		 * ASCII characters are classified, so that no byte of a multibyte
+		 * sequence is ever taken for a blank or a digit.
+		 * @return	@c true if strings are treated as UTF-8.
+		 */
+		bool utf8() const noexcept {
+			return this->_utf8;
+		}
+
+		/**
+		 * Turns UTF-8 mode on or off, which imbue() resets to whether the
+		 * new locale uses UTF-8. Only @c char strings can be UTF-8.
+		 * @param enable	Whether to treat strings as UTF-8.
+		 */
+		void utf8(bool enable) noexcept {
+			this->_utf8 = enable && sizeof(CharT) == 1;
+			this->_classic = this->_table->classic || this->_utf8;
+		}
+
 		char_type widen(char c) const {
-			const std::ctype<CharT>& ctype_facet = std::use_facet<std::ctype<CharT>>(this->_locale);
-			return ctype_facet.widen(c);
+			return this->_table->ctype->widen(c);
+		}
+
+		string_type widen(const std::string& str) const {
+			return widen(*this->_table->ctype, str);
 		}
 
-		string_type widen(const std::string& str) const;
+		char_type carriage_return() const noexcept {
+			return this->_table->carriage_return;
+		}
+
+		char_type line_feed() const noexcept {
+			return this->_table->line_feed;
+		}
+
+		bool is_newline(char_type c) const noexcept {
+			if (this->_classic)
+				return classic_chars.is(classic_char_table::newline, c);
+			return symbol_traits::eq(c, this->_table->carriage_return)
+				|| symbol_traits::eq(c, this->_table->line_feed);
+		}
 
 		bool is_blank(char_type c) const {
+			if (this->_classic)
+				return classic_chars.is(classic_char_table::blank, c);
 #if HAVE_STD_ISBLANK
-			return std::isblank<CharT>(c, this->_locale);
+			return this->_table->ctype->is(std::ctype_base::blank, c);
 #else
-			return symbol_traits::eq(c, this->widen(' '))
-				|| symbol_traits::eq(c, this->widen('\t'));
+			return symbol_traits::eq(c, this->_table->space)
+				|| symbol_traits::eq(c, this->_table->tab);
 #endif
 		}
 
+		bool is_space(char_type c) const {
+			if (this->_classic)
+				return classic_chars.is(classic_char_table::space, c);
+			return this->_table->ctype->is(std::ctype_base::space, c);
+		}
+
 		bool is_digit(char_type c) const {
-			return std::isdigit(c, this->_locale);
+			if (this->_classic)
+				return classic_chars.is(classic_char_table::digit, c);
+			return this->_table->ctype->is(std::ctype_base::digit, c);
 		}
 
 		bool bool_value(const string_type& str, std::size_t* idx = nullptr) const;
 
-		std::int32_t int32_value(const string_type& str, std::size_t* idx = nullptr, int base = 10) const {
-#if HAVE_INT32_T_INT
-			return stoi(str, idx, base);
-#else
-			return stol(str, idx, base);
-#endif
-		}
+		/**
+		 * Converts an integer literal to a value of the configured integer
+		 * width.
+		 * @param str	A nonempty string of decimal digits.
+		 * @return		The value of @p str.
+		 * @throw std::invalid_argument	If @p str is not a string of decimal
+		 * 								digits.
+		 * @throw std::out_of_range		If the value of @p str is too large
+		 * 								for an integer_t.
+		 */
+		integer_t int_value(string_view_type str) const;
+
+		/**
+		 * Converts an integer literal of any length.
+		 * @param str	A nonempty string of decimal digits.
+		 * @return		The value of @p str.
+		 * @throw std::invalid_argument	If @p str is not a string of decimal
+		 * 								digits.
+		 */
+		bigint big_int_value(string_view_type str) const;
 
 		const string_type (&newlines() const noexcept)[3] {
-			return this->_newlines;
+			return this->_table->newlines;
 		}
 
 		const string_type& true_name() const noexcept {
-			return this->_true_name;
+			return this->_table->true_name;
 		}
 
 		const string_type& false_name() const noexcept {
-			return this->_false_name;
+			return this->_table->false_name;
 		}
 
 		const std::map<token_kind, string_type>& operator_table() const noexcept {
-			return this->_operator_table;
+			return this->_table->operator_table;
 		}
 
-	private:
-		locale_type _locale;
-		string_type _newlines[3];
-		string_type _true_name;
-		string_type _false_name;
-		std::map<token_kind, string_type> _operator_table;
+		const std::vector<std::pair<token_kind, string_type>>& operators() const noexcept {
+			return this->_table->operators;
+		}
 
-		void init();
+		/**
+		 * Returns the table for a locale. Tables of named locales are built
+		 * once per process and shared; a table of an unnamed locale, whose
+		 * facets cannot be told apart by name, is built on every call.
+		 * @param loc	A locale.
+		 * @return		The table for @p loc.
+		 */
+		static std::shared_ptr<const table_type> shared_table(const locale_type& loc);
+
+		static string_type widen(const std::ctype<CharT>& ctype_facet, const std::string& str);
+
+	private:
+		std::shared_ptr<const table_type> _table;
+		bool _utf8;
+		/// Whether classic_chars classifies characters, cached from the
+		/// table so that classifying a character needs no indirection.
+		bool _classic;
 	};
 } // namespace calc
 
@@ -11,21 +11,112 @@
 #ifndef CALC_SYMBOL_TRAITS_IPP
 #define CALC_SYMBOL_TRAITS_IPP
 
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+
 namespace calc {
+	namespace detail {
+		/// Returns whether @p loc classifies @c char exactly like the
+		/// classic locale.
+		inline bool has_classic_ctype(const std::locale& loc, char) {
+			return &std::use_facet<std::ctype<char>>(loc)
+			       == &std::use_facet<std::ctype<char>>(std::locale::classic())
+			       || loc.name() == "C" || loc.name() == "POSIX";
+		}
+
+		template <typename CharT>
+		bool has_classic_ctype(const std::locale&, CharT) {
+			return false;
+		}
+
+		/// Returns whether the codeset of the @c LC_CTYPE category of
+		/// @p loc, such as "en_US.UTF-8", is UTF-8.
+		inline bool has_utf8_codeset(const std::locale& loc, char) {
+			std::string name = loc.name();
+
+			// the name of a combined locale lists each category
+			const std::size_t category = name.find("LC_CTYPE=");
+			if (category != std::string::npos) {
+				const std::size_t start = category + 9;
+				name = name.substr(start, name.find(';', start) - start);
+			}
+
+			const std::size_t dot = name.find('.');
+			if (dot == std::string::npos)
+				return false;
+
+			std::string codeset;
+			for (std::size_t i = dot + 1; i < name.size() && name[i] != '@'; i++)
+				if (name[i] != '-')
+					codeset += static_cast<char>(std::tolower(static_cast<unsigned char>(name[i])));
+			return codeset == "utf8";
+		}
+
+		template <typename CharT>
+		bool has_utf8_codeset(const std::locale&, CharT) {
+			return false;
+		}
+	} // namespace detail
+
 	template <typename CharT>
-	constexpr std::size_t symbol_traits<CharT>::npos;
+	basic_symbol_table<CharT>::basic_symbol_table(const std::locale& loc) :
+		locale(loc), ctype(&std::use_facet<std::ctype<CharT>>(loc)),
+		classic(detail::has_classic_ctype(loc, CharT())),
+		utf8(detail::has_utf8_codeset(loc, CharT()))
+	{
+		typedef symbol_traits<CharT> traits_type;
+
+		const std::numpunct<CharT>& numpunct_facet = std::use_facet<std::numpunct<CharT>>(this->locale);
+
+		this->carriage_return = this->ctype->widen('\r');
+		this->line_feed = this->ctype->widen('\n');
+		this->space = this->ctype->widen(' ');
+		this->tab = this->ctype->widen('\t');
+
+		for (std::size_t i = 0; i < 3; i++)
+			this->newlines[i] = traits_type::widen(*this->ctype, symbol_base::newlines[i]);
+
+		this->true_name = numpunct_facet.truename();
+		this->false_name = numpunct_facet.falsename();
+
+		for (const auto& i : symbol_base::operator_table)
+			this->operator_table[i.first] = traits_type::widen(*this->ctype, i.second);
+
+		// a stable sort keeps operators of equal length in the order of their
+		// kinds, so that lexing does not depend on the standard library
+		this->operators.assign(this->operator_table.cbegin(), this->operator_table.cend());
+		std::stable_sort(this->operators.begin(), this->operators.end(),
+		[] (const auto& a, const auto& b) -> bool {
+			return a.second.size() > b.second.size();
+		});
+	}
 
 	template <typename CharT>
-	typename symbol_traits<CharT>::string_type
-	symbol_traits<CharT>::widen(const std::string& str) const {
-		const std::ctype<CharT>& ctype_facet = std::use_facet<std::ctype<CharT>>(this->_locale);
-		const std::size_t n = str.size();
+	constexpr std::size_t symbol_traits<CharT>::npos;
 
-		char_type* wstr = new char_type[n];
-		ctype_facet.widen(str.c_str(), str.c_str() + n, wstr);
-		string_type result(wstr, n);
-		delete[] wstr;
+	template <typename CharT>
+	std::shared_ptr<const typename symbol_traits<CharT>::table_type>
+	symbol_traits<CharT>::shared_table(const locale_type& loc) {
+		static std::mutex mutex;
+		static std::map<std::string, std::shared_ptr<const table_type>> tables;
+
+		const std::string name = loc.name();
+		if (name == "*")
+			return std::make_shared<const table_type>(loc);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		std::shared_ptr<const table_type>& table = tables[name];
+		if (!table)
+			table = std::make_shared<const table_type>(loc);
+		return table;
+	}
 
+	template <typename CharT>
+	typename symbol_traits<CharT>::string_type
+	symbol_traits<CharT>::widen(const std::ctype<CharT>& ctype_facet, const std::string& str) {
+		string_type result(str.size(), CharT());
+		ctype_facet.widen(str.data(), str.data() + str.size(), &result[0]);
 		return result;
 	}
 
@@ -38,7 +129,7 @@ namespace calc {
 		std::size_t start_index = 0;
 
 		while (start_index < str.size()
-		       && std::isspace(str[start_index], this->_locale))
+		       && this->is_space(str[start_index]))
 			start_index++;
 
 		bool result;
@@ -60,21 +151,36 @@ namespace calc {
 	}
 
 	template <typename CharT>
-	void symbol_traits<CharT>::init() {
-		const std::numpunct<CharT>& numpunct_facet = std::use_facet<std::numpunct<CharT>>(this->_locale);
-
-		for (std::size_t i = 0; i < 3; i++)
-			this->_newlines[i] = this->widen(symbol_base::newlines[i]);
-
-		this->_true_name = numpunct_facet.truename();
-		this->_false_name = numpunct_facet.falsename();
+	integer_t
+	symbol_traits<CharT>::int_value(string_view_type str) const {
+		if (str.empty())
+			throw std::invalid_argument("calc::symbol_traits::int_value");
+		for (CharT c : str)
+			if (c < CharT('0') || c > CharT('9'))
+				throw std::invalid_argument("calc::symbol_traits::int_value");
+
+		integer_t result;
+		if (!default_integer_policy::from_digits(str.data(), str.data() + str.size(), result))
+			throw std::out_of_range("calc::symbol_traits::int_value");
+		return result;
+	}
 
-		for (const auto& i : symbol_base::operator_table)
-			this->_operator_table[i.first] = this->widen(i.second);
+	template <typename CharT>
+	bigint
+	symbol_traits<CharT>::big_int_value(string_view_type str) const {
+		if (str.empty())
+			throw std::invalid_argument("calc::symbol_traits::big_int_value");
+		for (CharT c : str)
+			if (c < CharT('0') || c > CharT('9'))
+				throw std::invalid_argument("calc::symbol_traits::big_int_value");
+
+		return bigint::from_digits(str.data(), str.data() + str.size());
 	}
 
 	// Inhibit implicit instantiations for required instantiations, which are
 	// defined via explicit instantiations elsewhere.
+	extern template struct basic_symbol_table<char>;
+	extern template struct basic_symbol_table<wchar_t>;
 	extern template class symbol_traits<char>;
 	extern template class symbol_traits<wchar_t>;
 } // namespace calc
@@ -0,0 +1,94 @@
+#include "config.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "bigint.hpp"
+
+#include "check.hpp"
+
+static calc::bigint from_string(const std::string& s) {
+	return s[0] == '-' ? -calc::bigint::from_digits(s.data() + 1, s.data() + s.size())
+	                   : calc::bigint::from_digits(s.data(), s.data() + s.size());
+}
+
+static calc::bigint power(int base, int exponent) {
+	calc::bigint result = 1;
+	for (int i = 0; i < exponent; i++)
+		result *= base;
+	return result;
+}
+
+int main(int argc, char* argv[]) {
+	// values stay inline until they overflow 64 bits, and return there
+	const calc::bigint max = INT64_MAX;
+	const calc::bigint min = INT64_MIN;
+	CHECK(max.is_small() && min.is_small());
+	CHECK(!(max + 1).is_small() && (max + 1).to_string() == "9223372036854775808");
+	CHECK((max + 1 - 1).is_small() && max + 1 - 1 == max);
+	CHECK(!(-min).is_small() && -(-min) == min);
+	CHECK((min - 1).to_string() == "-9223372036854775809");
+	CHECK(min / -1 == max + 1 && (min % -1).is_zero());
+	CHECK(from_string("-9223372036854775808").is_small());
+	CHECK(from_string("000000000000000000000000042") == 42);
+
+	std::int64_t small;
+	CHECK(max.narrow<calc::integer_policy<64>>(small) && small == INT64_MAX);
+	CHECK(!(max + 1).narrow<calc::integer_policy<64>>(small));
+	CHECK(min.narrow<calc::integer_policy<64>>(small) && small == INT64_MIN);
+	std::int32_t smaller;
+	CHECK(!max.narrow<calc::integer_policy<32>>(smaller));
+	CHECK(calc::bigint(-5).narrow<calc::integer_policy<32>>(smaller) && smaller == -5);
+#if HAVE_INT128
+	__int128 large;
+	CHECK((max * max).narrow<calc::integer_policy<128>>(large)
+	      && large == static_cast<__int128>(INT64_MAX) * INT64_MAX);
+	CHECK(calc::bigint(-large) == -(max * max));
+	CHECK(!power(2, 127).narrow<calc::integer_policy<128>>(large));
+	CHECK((-power(2, 127)).narrow<calc::integer_policy<128>>(large) && large < 0);
+#endif
+
+	calc::bigint factorial = 1;
+	for (int i = 2; i <= 30; i++)
+		factorial *= i;
+	CHECK(factorial.to_string() == "265252859812191058636308480000000");
+	CHECK(from_string(factorial.to_string()) == factorial);
+	for (int i = 31; i <= 100; i++)
+		factorial *= i;
+	CHECK(factorial.to_string().size() == 158
+	      && factorial.to_string().compare(0, 20, "93326215443944152681") == 0);
+	CHECK(factorial % 1000000007 == 437918130);
+
+	// operands of more limbs than the Karatsuba threshold, whose product
+	// is checked against one computed a small factor at a time
+	const calc::bigint a = power(7, 1000);
+	const calc::bigint b = power(3, 1100);
+	calc::bigint product = a;
+	for (int i = 0; i < 1100; i++)
+		product *= 3;
+	CHECK(a * b == product && b * a == product);
+	CHECK(a * a * a == power(7, 3000));
+
+	// long division
+	const calc::bigint c = b - 12345;
+	CHECK((product + c) / b == a && (product + c) % b == c);
+	CHECK((-(product + c)) / b == -a && (-(product + c)) % b == -c);
+	CHECK((product + c) / -b == -a && (product + c) % -b == c);
+	CHECK(power(2, 200) / (power(2, 100) - 1) == power(2, 100) + 1);
+	CHECK(a / product == 0 && a % product == a);
+
+	CHECK(-a < a && a < product && -product < -a && product > b);
+	CHECK(min < max + 1 && -(max + 1) == min && -(max + 2) < min);
+
+	bool thrown = false;
+	try {
+		static_cast<void>(a / 0);
+	}
+	catch (const std::domain_error&) {
+		thrown = true;
+	}
+	CHECK(thrown);
+
+	return failures == 0 ? 0 : 1;
+}
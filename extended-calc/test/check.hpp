@@ -0,0 +1,17 @@
+#ifndef CALC_TEST_CHECK_HPP
+#define CALC_TEST_CHECK_HPP
+
+#include <iostream>
+
+// the number of failed checks, which decides the exit status of a test
+static int failures = 0;
+
+#define CHECK(x) \
+	do { \
+		if (!(x)) { \
+			std::cout << __FILE__ << ':' << __LINE__ << ": check failed: " << #x << std::endl; \
+			failures++; \
+		} \
+	} while (false)
+
+#endif // CALC_TEST_CHECK_HPP
@@ -0,0 +1,36 @@
+# Runs PROGRAM with and without OPTIONS on INPUT, and fails unless the
+# output, the error output and the exit status are the same. Text that
+# matches ERROR_FILTER, if given, is removed from the error outputs first.
+#
+# Usage: cmake -DPROGRAM=<program> -DOPTIONS=<options> -DINPUT=<file>
+#              [-DERROR_FILTER=<regex>] -P compare_output.cmake
+#
+# OPTIONS are separated by spaces.
+
+separate_arguments(OPTIONS)
+
+execute_process(
+	COMMAND ${PROGRAM} ${INPUT}
+	OUTPUT_VARIABLE expected_output
+	ERROR_VARIABLE expected_error
+	RESULT_VARIABLE expected_result)
+execute_process(
+	COMMAND ${PROGRAM} ${OPTIONS} ${INPUT}
+	OUTPUT_VARIABLE actual_output
+	ERROR_VARIABLE actual_error
+	RESULT_VARIABLE actual_result)
+
+if(ERROR_FILTER)
+	string(REGEX REPLACE "${ERROR_FILTER}" "" expected_error "${expected_error}")
+	string(REGEX REPLACE "${ERROR_FILTER}" "" actual_error "${actual_error}")
+endif()
+
+if(NOT actual_output STREQUAL expected_output)
+	message(FATAL_ERROR "${PROGRAM} ${OPTIONS} printed:\n${actual_output}\ninstead of:\n${expected_output}")
+endif()
+if(NOT actual_error STREQUAL expected_error)
+	message(FATAL_ERROR "${PROGRAM} ${OPTIONS} reported:\n${actual_error}\ninstead of:\n${expected_error}")
+endif()
+if(NOT actual_result STREQUAL expected_result)
+	message(FATAL_ERROR "${PROGRAM} ${OPTIONS} exited with ${actual_result} instead of ${expected_result}.")
+endif()
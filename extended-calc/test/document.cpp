@@ -0,0 +1,84 @@
+#include "config.hpp"
+
+#include "cli.hpp"
+#include "document.hpp"
+
+#include "check.hpp"
+
+int main(int argc, char* argv[]) {
+	calc::init(argv[0]);
+
+	calc::document document("1 + 2\n3 * 4\n5 +\n");
+	CHECK(document.line_count() == 4);
+	CHECK(document.parsed_line_count() == 4);
+	CHECK(document.tree(1) && document.diagnostics(1).empty());
+	CHECK(document.diagnostics(3).size() == 1);
+	CHECK(!document.tree(4));
+
+	// an edit within a line only parses that line, and keeps the others
+	const calc::expr* const first = document.tree(1);
+	const calc::expr* const third = document.tree(3);
+	document.edit(2, 1, 2, 2, "(7");
+	CHECK(document.parsed_line_count() == 1);
+	CHECK(document.line(2) == "(7 * 4");
+	CHECK(document.tree(1) == first && document.tree(3) == third);
+	CHECK(document.diagnostics(2).size() == 1
+	      && document.diagnostics(2)[0].code == calc::error_id::missing_end_parenthesis
+	      && document.diagnostics(2)[0].start_column_number == 1);
+
+	// inserting a line feed splits a line
+	document.edit(3, 4, 3, 4, " 6\n8");
+	CHECK(document.line_count() == 5);
+	CHECK(document.parsed_line_count() == 2);
+	CHECK(document.line(3) == "5 + 6" && document.line(4) == "8");
+	CHECK(document.diagnostics(3).empty() && document.tree(3) != third);
+	CHECK(document.tree(1) == first);
+
+	// deleting across lines joins them
+	document.edit(2, 7, 4, 1, ")\n");
+	CHECK(document.line_count() == 4);
+	CHECK(document.text() == "1 + 2\n(7 * 4)\n8\n");
+	CHECK(document.diagnostics(2).empty());
+	CHECK(*document.tree(2)->value() == calc::integer_value(28));
+
+	// a carriage return ends a line, as it does for the lexer, and so does
+	// a carriage return and line feed
+	calc::document newline_document("1+2\r3*4\r\n5 -\n6");
+	CHECK(newline_document.line_count() == 4);
+	CHECK(newline_document.line(2) == "3*4" && newline_document.line(3) == "5 -");
+	CHECK(*newline_document.tree(1)->value() == calc::integer_value(3));
+	CHECK(*newline_document.tree(2)->value() == calc::integer_value(12));
+	CHECK(newline_document.diagnostics(3).size() == 1);
+	CHECK(newline_document.text() == "1+2\r3*4\r\n5 -\n6");
+
+	// an edit that puts a line feed after a carriage return joins them
+	newline_document.edit(2, 1, 2, 4, "\n7");
+	CHECK(newline_document.line_count() == 4);
+	CHECK(newline_document.line(2) == "7" && newline_document.line(1) == "1+2");
+	CHECK(newline_document.text() == "1+2\r\n7\r\n5 -\n6");
+	newline_document.edit(3, 4, 3, 4, "\r");
+	CHECK(newline_document.line_count() == 4);
+	CHECK(newline_document.text() == "1+2\r\n7\r\n5 -\r\n6");
+	newline_document.edit(2, 2, 3, 4, "");
+	CHECK(newline_document.line_count() == 3);
+	CHECK(newline_document.text() == "1+2\r\n7\r\n6");
+
+	// in UTF-8 mode, columns count code points
+	calc::document utf8_document("\u03c0 + (2");
+	utf8_document.utf8(true);
+	CHECK(utf8_document.diagnostics(1).size() == 2
+	      && utf8_document.diagnostics(1)[1].start_column_number == 5);
+	utf8_document.edit(1, 5, 1, 6, "[");
+	CHECK(utf8_document.line(1) == "\u03c0 + [2");
+
+	bool thrown = false;
+	try {
+		document.edit(3, 1, 2, 1, "");
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	CHECK(thrown);
+
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,43 @@
+# Emits the C source of INPUT, compiles it with CALC_RULES_MAIN defined, and
+# fails unless the program prints the values that calc prints and reports
+# as many divisions by zero.
+#
+# Usage: cmake -DCALC=<calc> -DC_COMPILER=<cc> -DINPUT=<file>
+#              -DOUTPUT=<prefix> -P emit_c.cmake
+
+execute_process(
+	COMMAND ${CALC} --emit-c ${INPUT}
+	OUTPUT_FILE ${OUTPUT}.c
+	RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "calc --emit-c exited with ${result}.")
+endif()
+
+execute_process(
+	COMMAND ${C_COMPILER} -DCALC_RULES_MAIN -o ${OUTPUT} ${OUTPUT}.c
+	ERROR_VARIABLE error
+	RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "${C_COMPILER} rejected ${OUTPUT}.c:\n${error}")
+endif()
+
+execute_process(
+	COMMAND ${CALC} ${INPUT}
+	OUTPUT_VARIABLE expected_output
+	ERROR_VARIABLE expected_error)
+execute_process(
+	COMMAND ${OUTPUT}
+	OUTPUT_VARIABLE actual_output
+	ERROR_VARIABLE actual_error)
+
+if(NOT actual_output STREQUAL expected_output)
+	message(FATAL_ERROR "The rules of ${INPUT} printed:\n${actual_output}\ninstead of:\n${expected_output}")
+endif()
+# the messages name the rule instead of the program
+string(REGEX MATCHALL "Attempt to divide by zero" expected_divisions "${expected_error}")
+string(REGEX MATCHALL "Attempt to divide by zero" actual_divisions "${actual_error}")
+list(LENGTH expected_divisions expected_count)
+list(LENGTH actual_divisions actual_count)
+if(NOT actual_count EQUAL expected_count)
+	message(FATAL_ERROR "The rules of ${INPUT} divided by zero ${actual_count} times instead of ${expected_count}.")
+endif()
@@ -0,0 +1,20 @@
+# Emits the LLVM IR of INPUT, and fails unless llvm-as accepts it.
+#
+# Usage: cmake -DCALC=<calc> -DLLVM_AS=<llvm-as> -DINPUT=<file>
+#              -DOUTPUT=<prefix> -P emit_llvm.cmake
+
+execute_process(
+	COMMAND ${CALC} --emit-llvm ${INPUT}
+	OUTPUT_FILE ${OUTPUT}.ll
+	RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "calc --emit-llvm exited with ${result}.")
+endif()
+
+execute_process(
+	COMMAND ${LLVM_AS} ${OUTPUT}.ll -o ${OUTPUT}.bc
+	ERROR_VARIABLE error
+	RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "llvm-as rejected ${OUTPUT}.ll:\n${error}")
+endif()
@@ -1,7 +1,9 @@
 #include "config.hpp"
 
+#include <cstring>
 #include <iostream>
 #include <fstream>
+#include <vector>
 
 #include "cli.hpp"
 #include "lexer.hpp"
@@ -11,6 +13,12 @@
 int main(int argc, char* argv[]) {
 	calc::init(argv[0]);
 
+	const bool utf8 = argc > 1 && std::strcmp(argv[1], "--utf8") == 0;
+	if (utf8) {
+		argv++;
+		argc--;
+	}
+
 	if (argc > 2) {
 		calc::report_error("Too many arguments.");
 		return 2;
@@ -33,6 +41,10 @@ int main(int argc, char* argv[]) {
 
 	calc::lexer lexer(buffer);
 	std::size_t token_count = 0;
+	std::vector<calc::script_extent> extents;
+
+	if (utf8)
+		lexer.utf8(true);
 
 	try {
 		while (true) {
@@ -116,6 +128,7 @@ int main(int argc, char* argv[]) {
 			std::cout << '\n';
 			std::cout << "\ttext: " << token.text();
 			std::cout << std::endl;
+			extents.push_back(token.extent());
 
 			if (token.kind() == calc::token_kind::eof)
 				break;
@@ -127,5 +140,21 @@ int main(int argc, char* argv[]) {
 		return 1;
 	}
 
+	// the batch resolver must agree with the extents themselves
+	const std::vector<calc::script_extent_location> locations =
+		calc::script_extent::resolve(extents.crbegin(), extents.crend());
+	for (std::size_t i = 0; i < extents.size(); i++) {
+		const calc::script_extent& extent = extents[extents.size() - 1 - i];
+		const calc::script_extent_location& location = locations[i];
+		if (location.start.line_number != extent.start_line_number()
+		    || location.start.column_number != extent.start_column_number()
+		    || location.end.line_number != extent.end_line_number()
+		    || location.end.column_number != extent.end_column_number()) {
+			calc::report_error("Batch resolution of token %zu disagrees with its extent.",
+				extents.size() - i);
+			return 1;
+		}
+	}
+
 	return 0;
 }
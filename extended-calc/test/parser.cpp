@@ -1,16 +1,38 @@
 #include "config.hpp"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <fstream>
+#include <string>
+#include <vector>
 
 #include "cli.hpp"
+#include "parse_context.hpp"
 #include "parser.hpp"
+#include "push_parser.hpp"
 
 #define LOG_EXPR(x) std::cout << #x << " = " << (x) << std::endl
 
 int main(int argc, char* argv[]) {
 	calc::init(argv[0]);
 
+	// evaluate each line with its own reset of one parse context
+	const bool context = argc > 1 && std::strcmp(argv[1], "--context") == 0;
+	if (context) {
+		argv++;
+		argc--;
+	}
+
+	// feed the input to a push parser in chunks of this many characters
+	std::size_t push_chunk_size = 0;
+	if (argc > 2 && std::strcmp(argv[1], "--push") == 0) {
+		push_chunk_size = std::max(1ul, std::strtoul(argv[2], nullptr, 10));
+		argv += 2;
+		argc -= 2;
+	}
+
 	if (argc > 2) {
 		calc::report_error("Too many arguments.");
 		return 2;
@@ -31,6 +53,58 @@ int main(int argc, char* argv[]) {
 		buffer = std::cin.rdbuf();
 	}
 
+	if (push_chunk_size > 0) {
+		calc::push_parser parser;
+		std::vector<char> chunk(push_chunk_size);
+		std::streamsize n;
+
+		do {
+			n = buffer->sgetn(chunk.data(), chunk.size());
+			if (n > 0)
+				parser.feed(chunk.data(), n);
+			else
+				parser.finish();
+
+			while (true) {
+				calc::parse_result result = parser.try_next_expr();
+				if (!result) {
+					calc::report_error(result.error());
+					continue;
+				}
+				if (!result.value())
+					break;
+				try {
+					std::cout << *result.value()->value() << std::endl;
+				}
+				catch (const std::domain_error& exception) {
+					calc::report_error("Division by zero.");
+				}
+			}
+		} while (n > 0);
+		return 0;
+	}
+
+	if (context) {
+		std::istream lines(buffer);
+		calc::parse_context context;
+		std::string line;
+
+		while (std::getline(lines, line)) {
+			try {
+				std::unique_ptr<calc::value> value = context.evaluate_one(line);
+				if (value)
+					std::cout << *value << std::endl;
+			}
+			catch (const calc::parse_error& exception) {
+				calc::report_error(exception);
+			}
+			catch (const std::domain_error& exception) {
+				calc::report_error("Division by zero.");
+			}
+		}
+		return 0;
+	}
+
 	try {
 		calc::parser parser(buffer);
 
@@ -41,7 +115,7 @@ int main(int argc, char* argv[]) {
 				std::unique_ptr<const calc::expr> expr = parser.next_expr();
 				if (!expr)
 					break;
-				std::cout << expr->value() << std::endl;
+				std::cout << *expr->value() << std::endl;
 			}
 			catch (const calc::parse_error& exception) {
 				calc::report_error(exception);
@@ -0,0 +1,248 @@
+#include "config.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "cli.hpp"
+#include "generator.hpp"
+#include "parser.hpp"
+
+// The exit status that CTest reports as a skipped test.
+static const int skip_status = 77;
+
+// The size of every generated corpus, in bytes.
+static const std::size_t corpus_size = 256 * 1024;
+
+typedef std::chrono::steady_clock clock_type;
+
+/**
+ * Generates one of the fixed corpora. The seeds are part of the baseline:
+ * changing them, or the generator, invalidates the recorded throughputs.
+ */
+static bool generate_corpus(const std::string& name, std::string& out) {
+	calc::generator_options options;
+
+	if (name == "default") {
+		options.seed = 1;
+	}
+	else if (name == "boolean") {
+		options.seed = 2;
+		options.boolean_ratio = 1.0;
+	}
+	else if (name == "deep") {
+		options.seed = 3;
+		options.max_depth = 8;
+		options.max_width = 2;
+	}
+	else {
+		return false;
+	}
+
+	calc::expr_generator generator(options);
+	while (out.size() < corpus_size)
+		generator.generate_line(out);
+	return true;
+}
+
+/// Returns the time it takes to lex every token of @p corpus.
+static double time_lexer(const std::string& corpus) {
+	std::stringbuf buffer(corpus);
+	calc::lexer lexer(&buffer);
+
+	const clock_type::time_point start = clock_type::now();
+	while (lexer.next_token().kind() != calc::token_kind::eof)
+		;
+	return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+/// Returns the time it takes to parse every expression of @p corpus.
+static double time_parser(const std::string& corpus) {
+	std::stringbuf buffer(corpus);
+	calc::parser parser(&buffer);
+
+	const clock_type::time_point start = clock_type::now();
+	while (parser.next_expr())
+		;
+	return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+static double median(std::vector<double> values) {
+	std::sort(values.begin(), values.end());
+	const std::size_t n = values.size();
+	return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+/// Returns the median absolute deviation of @p values from @p center.
+static double median_deviation(const std::vector<double>& values, double center) {
+	std::vector<double> deviations;
+	for (double value : values)
+		deviations.push_back(std::fabs(value - center));
+	return median(deviations);
+}
+
+/**
+ * The baseline file: a build type, followed by one throughput in MB/s per
+ * test. Lines starting with '#' are comments and are kept on update.
+ */
+class baseline_file {
+public:
+	explicit baseline_file(const std::string& path) : _path(path) {
+		std::ifstream in(path);
+		std::string line;
+
+		while (std::getline(in, line)) {
+			std::istringstream fields(line);
+			std::string key, value;
+
+			if (line.empty() || line[0] == '#' || !(fields >> key >> value))
+				this->_comments.push_back(line);
+			else if (key == "build_type")
+				this->_build_type = value;
+			else
+				this->_entries.push_back(std::make_pair(key, std::strtod(value.c_str(), nullptr)));
+		}
+	}
+
+	const std::string& build_type() const {
+		return this->_build_type;
+	}
+
+	/// Returns the throughput recorded for @p name, or 0 if there is none.
+	double get(const std::string& name) const {
+		for (const auto& i : this->_entries)
+			if (i.first == name)
+				return i.second;
+		return 0;
+	}
+
+	void set(const std::string& build_type, const std::string& name, double value) {
+		// throughputs of another build type are meaningless next to this one
+		if (this->_build_type != build_type)
+			this->_entries.clear();
+		this->_build_type = build_type;
+
+		for (auto& i : this->_entries)
+			if (i.first == name) {
+				i.second = value;
+				return;
+			}
+		this->_entries.push_back(std::make_pair(name, value));
+		std::sort(this->_entries.begin(), this->_entries.end());
+	}
+
+	bool save() const {
+		std::ofstream out(this->_path);
+
+		for (const std::string& comment : this->_comments)
+			out << comment << '\n';
+		out << "build_type " << this->_build_type << '\n';
+		out << std::fixed << std::setprecision(3);
+		for (const auto& i : this->_entries)
+			out << i.first << ' ' << i.second << '\n';
+		return static_cast<bool>(out);
+	}
+
+private:
+	std::string _path;
+	std::string _build_type;
+	std::vector<std::string> _comments;
+	std::vector<std::pair<std::string, double>> _entries;
+};
+
+int main(int argc, char* argv[]) {
+	calc::init(argv[0]);
+
+	if (argc != 7) {
+		calc::report_error("Usage: test_perf BASELINE BUILD_TYPE lexer|parser CORPUS TOLERANCE REPETITIONS");
+		return 2;
+	}
+
+	const std::string build_type = *argv[2] ? argv[2] : "None";
+	const std::string phase = argv[3];
+	const std::string corpus_name = argv[4];
+	const std::string name = phase + "_" + corpus_name;
+	const double tolerance = std::strtod(argv[5], nullptr);
+	const unsigned long repetitions = std::max(1ul, std::strtoul(argv[6], nullptr, 10));
+	const char* const update = std::getenv("CALC_PERF_UPDATE");
+
+	double (*measure)(const std::string&);
+	if (phase == "lexer")
+		measure = time_lexer;
+	else if (phase == "parser")
+		measure = time_parser;
+	else {
+		calc::report_error("Unknown phase %s.", phase.c_str());
+		return 2;
+	}
+
+	std::string corpus;
+	if (!generate_corpus(corpus_name, corpus)) {
+		calc::report_error("Unknown corpus %s.", corpus_name.c_str());
+		return 2;
+	}
+
+	// a baseline of another build type says nothing about this build, so
+	// there is no point in measuring unless the baseline is being updated
+	baseline_file baseline(argv[1]);
+	const double expected = baseline.get(name);
+	const bool updating = update && *update && std::strcmp(update, "0") != 0;
+
+	if (!updating) {
+		if (!baseline.build_type().empty() && baseline.build_type() != build_type) {
+			std::cout << "Skipped: the baseline was recorded for " << baseline.build_type()
+			          << " builds, not " << build_type << " builds.\n";
+			return skip_status;
+		}
+		if (expected <= 0) {
+			std::cout << "Skipped: " << argv[1] << " has no baseline for " << name << ".\n";
+			return skip_status;
+		}
+	}
+
+	// the first run warms the caches and the allocator, and is discarded
+	measure(corpus);
+	std::vector<double> throughputs;
+	for (unsigned long i = 0; i < repetitions; i++)
+		throughputs.push_back(corpus.size() / measure(corpus) / 1e6);
+
+	const double measured = median(throughputs);
+	const double deviation = median_deviation(throughputs, measured);
+
+	std::cout << std::fixed << std::setprecision(3)
+	          << name << ": " << measured << " MB/s, median of " << repetitions
+	          << " (deviation " << deviation << " MB/s)\n";
+
+	if (updating) {
+		baseline.set(build_type, name, measured);
+		if (!baseline.save()) {
+			calc::report_error("Could not write %s.", argv[1]);
+			return 1;
+		}
+		std::cout << "Updated the baseline of " << name << " in " << argv[1] << ".\n";
+		return 0;
+	}
+
+	const double delta = (measured - expected) / expected;
+	std::cout << "Baseline " << expected << " MB/s, delta "
+	          << std::showpos << std::setprecision(1) << delta * 100 << std::noshowpos
+	          << "%, tolerance -" << tolerance * 100 << "%.\n";
+
+	if (delta < -tolerance) {
+		std::cout << "FAILED: " << name << " is " << -delta * 100
+		          << "% slower than the baseline.\n";
+		return 1;
+	}
+	if (delta > tolerance)
+		std::cout << name << " is " << delta * 100
+		          << "% faster than the baseline; consider updating it.\n";
+	return 0;
+}
@@ -0,0 +1,52 @@
+#include "config.hpp"
+
+#include <cstring>
+
+#include "cli.hpp"
+#include "push_parser.hpp"
+
+#include "check.hpp"
+
+static void feed(calc::push_parser& parser, const char* s) {
+	parser.feed(s, std::strlen(s));
+}
+
+static bool next_value_is(calc::push_parser& parser, int v) {
+	calc::parse_result result = parser.try_next_expr();
+	return result && result.value() && *result.value()->value() == calc::integer_value(v);
+}
+
+static bool next_is_empty(calc::push_parser& parser) {
+	calc::parse_result result = parser.try_next_expr();
+	return result && !result.value();
+}
+
+int main(int argc, char* argv[]) {
+	calc::init(argv[0]);
+
+	// a bare carriage return completes a line as soon as it arrives
+	calc::push_parser parser;
+	feed(parser, "1 + 2\r3");
+	CHECK(next_value_is(parser, 3));
+	CHECK(next_is_empty(parser));
+	feed(parser, " * 4\r");
+	CHECK(next_value_is(parser, 12));
+	CHECK(next_is_empty(parser));
+
+	// so does a CR LF split across chunks, whose line feed is skipped
+	feed(parser, "5\r");
+	CHECK(next_value_is(parser, 5));
+	feed(parser, "\n6 -");
+	CHECK(next_is_empty(parser));
+	feed(parser, " 7\r\n");
+	CHECK(next_value_is(parser, -1));
+	CHECK(next_is_empty(parser));
+
+	feed(parser, "8");
+	CHECK(next_is_empty(parser));
+	parser.finish();
+	CHECK(!parser.try_next_expr());
+	CHECK(next_is_empty(parser));
+
+	return failures == 0 ? 0 : 1;
+}
@@ -34,6 +34,7 @@ namespace calc {
 	class basic_token {
 		friend class basic_lexer<CharT, Traits>;
 		friend class basic_parser<CharT, Traits>;
+		friend class basic_token_buffer<CharT, Traits>;
 
 	public:
 		typedef CharT char_type;
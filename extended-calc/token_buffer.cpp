@@ -0,0 +1,16 @@
+/**
+ * @file		token_buffer.cpp
+ * Contains type definitions for compact storage of tokens.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#include "token_buffer.hpp"
+
+namespace calc {
+	// Explicit instantiations for the basic_token_buffer class template.
+	template class basic_token_buffer<char>;
+	template class basic_token_buffer<wchar_t>;
+} // namespace calc
@@ -0,0 +1,206 @@
+/**
+ * @file		token_buffer.hpp
+ * Contains type declarations for compact storage of tokens.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_TOKEN_BUFFER_HPP
+#define CALC_TOKEN_BUFFER_HPP
+
+#include "config.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "lexer_fwd.hpp"
+#include "token.hpp"
+
+namespace calc {
+	/**
+	 * Stores a sequence of tokens of one script as parallel arrays of
+	 * kinds, flags, and 32-bit offsets, relative to the first token, and
+	 * lengths, with the script position helper held once. A token takes 11
+	 * bytes instead of the 32 of a basic_token, and the kinds can be
+	 * scanned in bulk. Tokens are rebuilt on access.
+	 * @tparam CharT	The character type.
+	 * @tparam Traits	The symbol traits type.
+	 */
+	template <typename CharT, class Traits>
+	class basic_token_buffer {
+	public:
+		typedef CharT char_type;
+		typedef Traits traits_type;
+		typedef basic_script_extent<CharT, Traits> extent_type;
+		typedef basic_token<CharT, Traits> token_type;
+
+		/**
+		 * An iterator over the tokens of a buffer, which dereferences to a
+		 * token by value.
+		 */
+		class const_iterator {
+			friend class basic_token_buffer;
+
+		public:
+			typedef std::input_iterator_tag iterator_category;
+			typedef token_type value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef void pointer;
+			typedef token_type reference;
+
+			token_type operator*() const {
+				return (*this->_buffer)[this->_index];
+			}
+
+			const_iterator& operator++() noexcept {
+				this->_index++;
+				return *this;
+			}
+
+			const_iterator operator++(int) noexcept {
+				const_iterator old = *this;
+				this->_index++;
+				return old;
+			}
+
+			const_iterator& operator--() noexcept {
+				this->_index--;
+				return *this;
+			}
+
+			const_iterator operator--(int) noexcept {
+				const_iterator old = *this;
+				this->_index--;
+				return old;
+			}
+
+			std::size_t index() const noexcept {
+				return this->_index;
+			}
+
+			bool operator==(const const_iterator& other) const noexcept {
+				return this->_index == other._index;
+			}
+
+			bool operator!=(const const_iterator& other) const noexcept {
+				return this->_index != other._index;
+			}
+
+		private:
+			const basic_token_buffer* _buffer;
+			std::size_t _index;
+
+			const_iterator(const basic_token_buffer* buffer, std::size_t index) noexcept :
+				_buffer(buffer), _index(index)
+			{}
+		};
+
+		basic_token_buffer() :
+			_position_helper(nullptr), _base_offset(0), _kinds(), _flags(),
+			_start_offsets(), _lengths()
+		{}
+
+		std::size_t size() const noexcept {
+			return this->_kinds.size();
+		}
+
+		bool empty() const noexcept {
+			return this->_kinds.empty();
+		}
+
+		/**
+		 * Appends a token. The first token fixes the script and the offset
+		 * that the others are stored relative to.
+		 * @param token			A token of the same script as the others.
+		 * @throw std::length_error	If the token is more than 4 GiB away
+		 * 							from the first one.
+		 */
+		void push_back(const token_type& token);
+
+		void pop_back() noexcept {
+			assert(!this->empty());
+			this->_kinds.pop_back();
+			this->_flags.pop_back();
+			this->_start_offsets.pop_back();
+			this->_lengths.pop_back();
+		}
+
+		/// Removes every token, but keeps the storage.
+		void clear() noexcept {
+			this->_kinds.clear();
+			this->_flags.clear();
+			this->_start_offsets.clear();
+			this->_lengths.clear();
+		}
+
+		token_type operator[](std::size_t index) const noexcept {
+			return token_type(this->extent(index), this->kind(index), this->flags(index));
+		}
+
+		token_type back() const noexcept {
+			assert(!this->empty());
+			return (*this)[this->size() - 1];
+		}
+
+		const_iterator begin() const noexcept {
+			return const_iterator(this, 0);
+		}
+
+		const_iterator end() const noexcept {
+			return const_iterator(this, this->size());
+		}
+
+		token_kind kind(std::size_t index) const noexcept {
+			return static_cast<token_kind>(this->_kinds[index]);
+		}
+
+		token_flags flags(std::size_t index) const noexcept {
+			return static_cast<token_flags>(this->_flags[index]);
+		}
+
+		void flags(std::size_t index, token_flags flags) noexcept {
+			this->_flags[index] = static_cast<std::uint16_t>(flags);
+		}
+
+		std::size_t start_offset(std::size_t index) const noexcept {
+			return this->_base_offset + this->_start_offsets[index];
+		}
+
+		std::size_t end_offset(std::size_t index) const noexcept {
+			return this->start_offset(index) + this->_lengths[index];
+		}
+
+		extent_type extent(std::size_t index) const noexcept {
+			assert(this->_position_helper);
+			return extent_type(*this->_position_helper, this->start_offset(index), this->end_offset(index));
+		}
+
+		/**
+		 * Returns the kinds of the tokens, one byte each, for scanning many
+		 * tokens at once.
+		 * @return	The kinds of the tokens, in order.
+		 */
+		const std::vector<std::uint8_t>& kinds() const noexcept {
+			return this->_kinds;
+		}
+
+	private:
+		typedef basic_script_position_helper<CharT, Traits> position_helper_type;
+
+		const position_helper_type* _position_helper;
+		std::size_t _base_offset;
+		std::vector<std::uint8_t> _kinds;
+		std::vector<std::uint16_t> _flags;
+		std::vector<std::uint32_t> _start_offsets;
+		std::vector<std::uint32_t> _lengths;
+	};
+} // namespace calc
+
+#include "token_buffer.ipp"
+
+#endif // CALC_TOKEN_BUFFER_HPP
@@ -0,0 +1,48 @@
+/**
+ * @file		token_buffer.ipp
+ * Contains template definitions and explicit template instantiation
+ * declarations.
+ *
+ * @author		Jennifer Yao
+ * @date		10/18/2026
+ * @copyright	All rights reserved.
+ */
+
+#ifndef CALC_TOKEN_BUFFER_IPP
+#define CALC_TOKEN_BUFFER_IPP
+
+#include <limits>
+#include <stdexcept>
+
+namespace calc {
+	template <typename CharT, class Traits>
+	void
+	basic_token_buffer<CharT, Traits>::push_back(const typename basic_token_buffer<CharT, Traits>::token_type& token) {
+		const extent_type extent = token.extent();
+
+		if (this->empty()) {
+			this->_position_helper = &extent.position_helper();
+			this->_base_offset = extent.start_offset();
+		}
+		assert(*this->_position_helper == extent.position_helper());
+
+		const std::size_t start_offset = extent.start_offset() - this->_base_offset;
+		const std::size_t length = extent.end_offset() - extent.start_offset();
+		if (extent.start_offset() < this->_base_offset
+		    || start_offset > std::numeric_limits<std::uint32_t>::max()
+		    || length > std::numeric_limits<std::uint32_t>::max())
+			throw std::length_error("calc::basic_token_buffer::push_back");
+
+		this->_kinds.push_back(static_cast<std::uint8_t>(token.kind()));
+		this->_flags.push_back(static_cast<std::uint16_t>(token.flags()));
+		this->_start_offsets.push_back(static_cast<std::uint32_t>(start_offset));
+		this->_lengths.push_back(static_cast<std::uint32_t>(length));
+	}
+
+	// Inhibit implicit instantiations for required instantiations, which are
+	// defined via explicit instantiations elsewhere.
+	extern template class basic_token_buffer<char>;
+	extern template class basic_token_buffer<wchar_t>;
+} // namespace calc
+
+#endif // CALC_TOKEN_BUFFER_IPP